@@ -0,0 +1,94 @@
+#include "BuildTrace.h"
+#include <cstddef>
+#include <new>
+
+namespace {
+    // Objects released by the threads, deleted at thread exit. An object released after the free list of its thread
+    // is gone (by a static destroyed later) is deleted right away
+    template <typename T> struct FreeList {
+        std::vector<T *> objects;
+        static thread_local bool destroyed;
+
+        ~FreeList() {
+            for (T *object : objects) { delete object; }
+            destroyed = true;
+        }
+        static FreeList &local() {
+            static thread_local FreeList freeList;
+            return freeList;
+        }
+    };
+    template <typename T> thread_local bool FreeList<T>::destroyed = false;
+
+    // Blocks of raw memory of the size of a T, for the control blocks of the shared pointers
+    template <std::size_t Size> struct Block {
+        alignas(std::max_align_t) unsigned char bytes[Size];
+    };
+
+    template <typename T> struct RecyclingAllocator {
+        using value_type = T;
+
+        RecyclingAllocator() = default;
+        template <typename U> RecyclingAllocator(const RecyclingAllocator<U> &) {}
+
+        T *allocate(std::size_t n) {
+            auto &blocks = FreeList<Block<sizeof(T)>>::local().objects;
+            if (n == 1 && !blocks.empty()) {
+                Block<sizeof(T)> *block = blocks.back();
+                blocks.pop_back();
+                return reinterpret_cast<T *>(block);
+            }
+            return n == 1 ? reinterpret_cast<T *>(new Block<sizeof(T)>) : std::allocator<T>().allocate(n);
+        }
+        void deallocate(T *p, std::size_t n) {
+            if (n != 1) {
+                std::allocator<T>().deallocate(p, n);
+            } else if (FreeList<Block<sizeof(T)>>::destroyed) {
+                delete reinterpret_cast<Block<sizeof(T)> *>(p);
+            } else {
+                FreeList<Block<sizeof(T)>>::local().objects.push_back(reinterpret_cast<Block<sizeof(T)> *>(p));
+            }
+        }
+        template <typename U> bool operator==(const RecyclingAllocator<U> &) const { return true; }
+        template <typename U> bool operator!=(const RecyclingAllocator<U> &) const { return false; }
+    };
+
+    void clear(BuildTrace &trace) {
+        trace.repairmen.clear();
+        trace.trucks.clear();
+    }
+    template <typename Scheme> void clear(RouteAssignment<Scheme> &) {}
+
+    template <typename T> struct Recycle {
+        void operator()(T *object) const {
+            // a trace releases its assignments first
+            clear(*object);
+            if (FreeList<T>::destroyed) {
+                delete object;
+            } else {
+                FreeList<T>::local().objects.push_back(object);
+            }
+        }
+    };
+
+    template <typename T> std::shared_ptr<T> recycled() {
+        auto &objects = FreeList<T>::local().objects;
+        T *object;
+        if (objects.empty()) {
+            object = new T();
+        } else {
+            object = objects.back();
+            objects.pop_back();
+        }
+        return std::shared_ptr<T>(object, Recycle<T>(), RecyclingAllocator<T>());
+    }
+} // namespace
+
+std::shared_ptr<BuildTrace> newBuildTrace() { return recycled<BuildTrace>(); }
+
+template <typename Scheme> std::shared_ptr<RouteAssignment<Scheme>> newRouteAssignment() {
+    return recycled<RouteAssignment<Scheme>>();
+}
+
+template std::shared_ptr<RouteAssignment<RepositionSchemeRPM>> newRouteAssignment<RepositionSchemeRPM>();
+template std::shared_ptr<RouteAssignment<RepositionSchemeTRK>> newRouteAssignment<RepositionSchemeTRK>();
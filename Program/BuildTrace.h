@@ -0,0 +1,40 @@
+#pragma once
+
+#include "RepositionScheme.h"
+#include <memory>
+#include <vector>
+
+// Inventory of a station after some route assignments
+struct StationInventory {
+    int station;
+    int usable;
+    int broken;
+};
+
+// What the greedy assignment of one route did: Individual::buildIndividual assigns the repairmen routes, then the
+// truck routes, each one starting from the inventories the previous ones left
+template <typename Scheme> struct RouteAssignment {
+    std::vector<int> route;      // route handed to the assignment
+    std::vector<int> chromosome; // route kept in the chromosome
+    std::vector<Scheme> scheme;  // scheme before the amendments
+    // inventories of every station assigned so far (this route and the previous ones), sorted by station, the other
+    // stations keep their initial inventory
+    std::vector<StationInventory> inventory;
+};
+
+using RepairmenAssignment = std::vector<std::shared_ptr<const RouteAssignment<RepositionSchemeRPM>>>;
+using TrucksAssignment = std::vector<std::shared_ptr<const RouteAssignment<RepositionSchemeTRK>>>;
+
+// The route assignments of a build, shared by the copies of an individual. An individual built from routes that only
+// differ from a traced build after some route reuses the assignments before it instead of redoing them
+struct BuildTrace {
+    RepairmenAssignment repairmen;
+    TrucksAssignment trucks;
+};
+
+// A trace or an assignment no longer referenced goes back to a free list of the thread releasing it, with the
+// capacity of its vectors, and so do the control blocks of their shared pointers: once a few builds have filled the
+// free lists, the trace of a build allocates nothing. The trace comes back empty, the vectors of an assignment keep
+// their last content and are all assigned again by the build
+std::shared_ptr<BuildTrace> newBuildTrace();
+template <typename Scheme> std::shared_ptr<RouteAssignment<Scheme>> newRouteAssignment();
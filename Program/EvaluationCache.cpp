@@ -0,0 +1,43 @@
+#include "EvaluationCache.h"
+#include "Individual.h"
+#include "helpers/HashHelper.h"
+
+std::uint64_t EvaluationCache::hashRoutes(
+    const std::vector<std::vector<int>> &rpmRoutes, const std::vector<std::vector<int>> &trkRoutes) {
+    // the separator after the repairmen tells a repairman route from a truck route
+    std::uint64_t hash = HashHelper::hashRoutes(rpmRoutes);
+    hash = (hash ^ 0xFFFFFFFEULL) * HashHelper::fnvPrime;
+    return HashHelper::hashRoutes(trkRoutes, hash);
+}
+
+std::shared_ptr<const Individual> EvaluationCache::find(std::uint64_t key,
+    const std::vector<std::vector<int>> &rpmRoutes, const std::vector<std::vector<int>> &trkRoutes) {
+    if (slots.empty()) { return nullptr; }
+    const Slot &slot = slots[key & (slots.size() - 1)];
+    // a hash collision counts as a miss
+    if (slot.individual == nullptr || slot.key != key || slot.rpmRoutes != rpmRoutes || slot.trkRoutes != trkRoutes) {
+        nbMisses++;
+        return nullptr;
+    }
+    nbHits++;
+    return slot.individual;
+}
+
+void EvaluationCache::insert(std::uint64_t key, const std::vector<std::vector<int>> &rpmRoutes,
+    const std::vector<std::vector<int>> &trkRoutes, const Individual &individual) {
+    if (slots.empty()) { return; }
+    Slot &slot = slots[key & (slots.size() - 1)];
+    slot.key = key;
+    slot.rpmRoutes = rpmRoutes;
+    slot.trkRoutes = trkRoutes;
+    slot.individual = std::make_shared<const Individual>(individual);
+}
+
+void EvaluationCache::setCapacity(std::size_t nbSlots) {
+    std::size_t size = 0;
+    if (nbSlots > 0) {
+        size = 1;
+        while (size < nbSlots) { size <<= 1; }
+    }
+    slots.assign(size, Slot{});
+}
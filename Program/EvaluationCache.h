@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Individual;
+
+// Fixed-size, direct-mapped cache of the individuals built from given routes, indexed by a 64-bit hash of chromRPM
+// and chromTRK. A build only depends on the routes, so an individual rebuilt from routes seen before is copied from
+// the cache instead. The objective is computed again on a hit, as the penalty of the capacity excess changes during
+// the search. A slot holds one individual, a newer one replaces it.
+class EvaluationCache {
+public:
+    explicit EvaluationCache(std::size_t nbSlots = 1024) { setCapacity(nbSlots); }
+
+    static std::uint64_t hashRoutes(
+        const std::vector<std::vector<int>> &rpmRoutes, const std::vector<std::vector<int>> &trkRoutes);
+
+    // Individual built from the routes if it is cached (a hit), nullptr otherwise (a miss)
+    std::shared_ptr<const Individual> find(std::uint64_t key, const std::vector<std::vector<int>> &rpmRoutes,
+        const std::vector<std::vector<int>> &trkRoutes);
+    void insert(std::uint64_t key, const std::vector<std::vector<int>> &rpmRoutes,
+        const std::vector<std::vector<int>> &trkRoutes, const Individual &individual);
+    // Empties the cache and rounds the number of slots up to a power of two, 0 disables the cache
+    void setCapacity(std::size_t nbSlots);
+
+    bool enabled() const { return !slots.empty(); }
+    std::uint64_t hits() const { return nbHits; } // evaluations avoided
+    std::uint64_t misses() const { return nbMisses; }
+
+private:
+    struct Slot {
+        std::uint64_t key = 0;
+        std::vector<std::vector<int>> rpmRoutes; // routes the individual was built from
+        std::vector<std::vector<int>> trkRoutes;
+        std::shared_ptr<const Individual> individual;
+    };
+
+    std::vector<Slot> slots;
+    std::uint64_t nbHits = 0;
+    std::uint64_t nbMisses = 0;
+};
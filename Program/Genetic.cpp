@@ -1,4 +1,5 @@
 #include "Genetic.h"
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
@@ -211,6 +212,7 @@ Individual Genetic::crossoverOX(Individual &parent1, Individual &parent2) {
 }
 
 void Genetic::saveResults(Individual &bestSol, std::string fileName) {
+    bestSol.materializeSchemes(params, instance);
     std::ofstream resultFile;
     resultFile.open(fileName, std::ios::app);
     resultFile << "the best solution is: " << std::endl;
@@ -225,19 +227,19 @@ void Genetic::saveResults(Individual &bestSol, std::string fileName) {
     for (auto &scheme : bestSol.repositionSchemeVectorTruck) {
         resultFile << "=======" << std::endl;
         for (auto &subscheme : scheme) {
-            resultFile << subscheme->station << "\t";
-            resultFile << "load " << subscheme->loadingQuantityU << " usable bikes;";
-            resultFile << "load " << subscheme->loadingQuantityB << " broken bikes;";
-            resultFile << "unload " << subscheme->unloadingQuantityU << " usable bikes;";
-            resultFile << "unload " << subscheme->unloadingQuantityB << " broken bikes" << std::endl;
+            resultFile << subscheme.station << "\t";
+            resultFile << "load " << subscheme.loadingQuantityU << " usable bikes;";
+            resultFile << "load " << subscheme.loadingQuantityB << " broken bikes;";
+            resultFile << "unload " << subscheme.unloadingQuantityU << " usable bikes;";
+            resultFile << "unload " << subscheme.unloadingQuantityB << " broken bikes" << std::endl;
         }
     }
     resultFile << "the repositioning scheme for repairman is: " << std::endl;
     for (auto &scheme : bestSol.repositionSchemeVectorRepairman) {
         resultFile << "=======" << std::endl;
         for (auto &subscheme : scheme) {
-            resultFile << subscheme->station << "\t";
-            resultFile << "repair " << subscheme->repairingQuantity << " bikes" << std::endl;
+            resultFile << subscheme.station << "\t";
+            resultFile << "repair " << subscheme.repairingQuantity << " bikes" << std::endl;
         }
     }
     resultFile << std::endl;
@@ -245,8 +247,9 @@ void Genetic::saveResults(Individual &bestSol, std::string fileName) {
 
     // print the user dissatisfaction of each station
     resultFile << "dissat at each station" << std::endl;
-    for (int i = 0; i <= bestSol.eval.dissatisFaction.size() - 1; i++) {
-        resultFile << "dissat[" << i+1 << "] = " << bestSol.eval.dissatisFaction[i] << std::endl;
+    std::vector<double> dissatisfaction = bestSol.dissatByStation(instance);
+    for (int i = 0; i < dissatisfaction.size(); i++) {
+        resultFile << "dissat[" << i+1 << "] = " << dissatisfaction[i] << std::endl;
     }
     resultFile.close();
 }
@@ -1,9 +1,64 @@
 #include "Individual.h"
 #include "RepositionScheme.h"
+#include "helpers/BuildWorkspace.h"
 #include "helpers/TimeHelper.h"
 #include "helpers/Utils.h"
 #include <algorithm>
-#include <unordered_set>
+#include <numeric>
+
+namespace {
+    // inventories of the stations assigned so far once route is assigned as well
+    void inventoryAfter(const BuildTrace &trace, const std::vector<int> &route, const std::vector<int> &curUsable,
+        const std::vector<int> &curBroken, std::vector<StationInventory> &inventory) {
+        std::vector<int> &stations = BuildWorkspace::local().assignedStations;
+        stations.clear();
+        const std::vector<StationInventory> *previous = !trace.trucks.empty() ? &trace.trucks.back()->inventory
+                                                        : !trace.repairmen.empty() ? &trace.repairmen.back()->inventory
+                                                                                    : nullptr;
+        stations.reserve((previous == nullptr ? 0 : previous->size()) + route.size());
+        if (previous != nullptr) {
+            for (const auto &entry : *previous) { stations.push_back(entry.station); }
+        }
+        for (int station : route) {
+            if (station != 0) { stations.push_back(station); }
+        }
+        std::sort(stations.begin(), stations.end());
+        stations.erase(std::unique(stations.begin(), stations.end()), stations.end());
+        inventory.clear();
+        for (int station : stations) { inventory.push_back({station, curUsable[station], curBroken[station]}); }
+    }
+
+    void restoreInventory(
+        const std::vector<StationInventory> &inventory, std::vector<int> &curUsable, std::vector<int> &curBroken) {
+        for (const auto &entry : inventory) {
+            curUsable[entry.station] = entry.usable;
+            curBroken[entry.station] = entry.broken;
+        }
+    }
+
+    // number of leading routes whose assignment is the same as in the reference
+    template <typename Scheme>
+    std::size_t nbReusable(const std::vector<std::shared_ptr<const RouteAssignment<Scheme>>> &reference,
+        const std::vector<std::vector<int>> &routes) {
+        std::size_t nbRoutes = 0;
+        while (nbRoutes < reference.size() && nbRoutes < routes.size()
+               && reference[nbRoutes]->route == routes[nbRoutes]) {
+            nbRoutes++;
+        }
+        return nbRoutes;
+    }
+
+    // removes the stops of the scheme, but the first and the last, that do no
+    // operation; they leave the inventories and the loads of the vehicle as
+    // they are, so the rest of the scheme stays valid. The route is rebuilt
+    // from the kept stops
+    template <typename Scheme, typename IsIdle>
+    void dropIdleStops(std::vector<Scheme> &scheme, std::vector<int> &route, IsIdle isIdle) {
+        scheme.erase(std::remove_if(scheme.begin() + 1, scheme.end() - 1, isIdle), scheme.end() - 1);
+        route.clear();
+        for (const auto &stop : scheme) { route.push_back(stop.station); }
+    }
+} // namespace
 
 Individual::Individual() = default;
 
@@ -15,8 +70,11 @@ Individual::Individual(Params &params, Instance &instance) :
     chromRPM(std::vector<std::vector<int>>(params.nbRepairmen)),
     chromTRK(std::vector<std::vector<int>>(params.nbVehicles)) {
     // the initial inventory is assigned first
-    std::vector<int> curUsable(params.nbClients + 1);
-    std::vector<int> curBroken(params.nbClients + 1);
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    std::vector<int> &curUsable = workspace.usable;
+    std::vector<int> &curBroken = workspace.broken;
+    curUsable.assign(params.nbClients + 1, 0);
+    curBroken.assign(params.nbClients + 1, 0);
 
     for (int i = 1; i <= params.nbClients; i++) {
         curUsable[i] = instance.networkInfo[i].usableBike;
@@ -36,7 +94,20 @@ Individual::Individual(Params &params, Instance &instance) :
  * @param chromTRK
  */
 Individual::Individual(Params &params, Instance &instance, const std::vector<std::vector<int>> &rpmRoutes,
-    const std::vector<std::vector<int>> &trkRoutes) : chromRPM(rpmRoutes), chromTRK(trkRoutes) {
+    const std::vector<std::vector<int>> &trkRoutes, const BuildTrace *reference) {
+    // the same routes always build the same individual, only the penalty of
+    // the capacity excess may have changed since it was cached
+    std::uint64_t key = 0;
+    if (params.evaluationCache.enabled()) {
+        key = EvaluationCache::hashRoutes(rpmRoutes, trkRoutes);
+        if (auto cached = params.evaluationCache.find(key, rpmRoutes, trkRoutes)) {
+            *this = *cached;
+            solutionEvaluation(params);
+            return;
+        }
+    }
+    chromRPM = rpmRoutes;
+    chromTRK = trkRoutes;
     // remove the intermediate 0 in chromRPM (i.e., remove 0 in chromRPM except
     // for the first and the end)
     for (auto &chrom : chromRPM) {
@@ -45,13 +116,15 @@ Individual::Individual(Params &params, Instance &instance, const std::vector<std
                 std::remove_if(chrom.begin() + 1, chrom.end() - 1, [](int i) { return i == 0; }), chrom.end() - 1);
     }
 
-    std::vector<int> curUsable(params.nbClients + 1);
-    std::vector<int> curBroken(params.nbClients + 1);
-    buildIndividual(params, curUsable, curBroken, instance);
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    workspace.usable.assign(params.nbClients + 1, 0);
+    workspace.broken.assign(params.nbClients + 1, 0);
+    buildIndividual(params, workspace.usable, workspace.broken, instance, reference);
+    params.evaluationCache.insert(key, rpmRoutes, trkRoutes, *this);
 }
 
-void Individual::buildIndividual(
-    Params &params, std::vector<int> &curUsable, std::vector<int> &curBroken, Instance &instance) {
+void Individual::buildIndividual(Params &params, std::vector<int> &curUsable, std::vector<int> &curBroken,
+    Instance &instance, const BuildTrace *reference) {
     combineTheConsecutiveDuplicateNode(chromRPM, true);
     combineTheConsecutiveDuplicateNode(chromTRK, false);
     for (int i = 1; i <= params.nbClients; i++) {
@@ -59,14 +132,16 @@ void Individual::buildIndividual(
         curBroken[i] = instance.networkInfo[i].brokenBike;
     }
 
-    greedyAssignmentForRepairman(params, curUsable, curBroken, chromRPM, instance);
-    greedyAssignmentForTrucks(params, curUsable, curBroken, chromTRK, instance);
+    std::shared_ptr<BuildTrace> newTrace = newBuildTrace();
+    greedyAssignmentForRepairman(params, curUsable, curBroken, chromRPM, instance, *newTrace, reference);
+    greedyAssignmentForTrucks(params, curUsable, curBroken, chromTRK, instance, *newTrace, reference);
+    trace = std::move(newTrace);
 
-    // get the station id set appeared in truckSchemeVector
-    std::unordered_set<int> rpmStationSet;
-    // get the station id set appeared in truckSchemeVector
+    // mark the stations appearing in repositionSchemeVectorRepairman
+    std::vector<bool> &rpmStationSet = BuildWorkspace::local().inRepairmanRoute;
+    rpmStationSet.assign(params.nbClients + 1, false);
     for (auto &rpmScheme : repositionSchemeVectorRepairman) {
-        for (auto &stationRepairScheme : rpmScheme) { rpmStationSet.insert(stationRepairScheme->station); }
+        for (auto &stationRepairScheme : rpmScheme) { rpmStationSet[stationRepairScheme.station] = true; }
     }
 
     for (int i = 0; i < params.nbVehicles; i++) {
@@ -95,48 +170,50 @@ void Individual::buildIndividual(
 
 void Individual::rpmRouteInit(Params &params, std::vector<std::vector<int>> &rpmVector, std::vector<int> &curUsable,
     std::vector<int> &curBroken, Instance &instance) {
-    // the unVisited list is initialized as the set of all the stations from 1 to
-    // nbClients
-    std::unordered_set<int> unVisited = {};
-    for (int i = 1; i <= params.nbClients; i++) { unVisited.insert(i); }
+    // the unvisited stations are the first nbUnvisited ones of a flat array,
+    // initialized with all the stations from 1 to nbClients
+    std::vector<int> &unVisited = BuildWorkspace::local().unvisitedStations;
+    unVisited.resize(params.nbClients);
+    std::iota(unVisited.begin(), unVisited.end(), 1);
+    int nbUnvisited = params.nbClients;
     for (int i = 0; i < params.nbRepairmen; i++) {
         rpmVector[i].push_back(0);
         int curStation = 0;
         double remainingTime = params.timeBudget;
-        while (remainingTime > 0 && !unVisited.empty()) {
-            // randomly pick up one station from the unvisited station
-            std::unordered_set<int> stationCandidates = unVisited;
-            int nextStation
-                = *std::next(stationCandidates.begin(), static_cast<int>(params.ran() % stationCandidates.size()));
-            double timeToNextStation = instance.dist_mtx[curStation][nextStation] * 1.68;
-            double timeToDepot = instance.dist_mtx[nextStation][0] * 1.68;
-            double timeLeftForRepair = remainingTime - timeToNextStation - timeToDepot;
-            // if the next station is already visited, we need to randomly pick up
-            // another station stationCandidates is initialized as the unvisited stations
-            while (timeLeftForRepair < params.repairTime && !stationCandidates.empty()) {
-                // randomly pick up one station from the stationCandidates
-                nextStation
-                    = *std::next(stationCandidates.begin(), static_cast<int>(params.ran() % stationCandidates.size()));
-                stationCandidates.erase(nextStation);
-                timeToNextStation = instance.dist_mtx[curStation][nextStation] * 1.68;
-                timeToDepot = instance.dist_mtx[nextStation][0] * 1.68;
-                timeLeftForRepair = remainingTime - timeToNextStation - timeToDepot;
+        while (remainingTime > 0 && nbUnvisited > 0) {
+            // randomly pick up unvisited stations until one leaves time for a
+            // repair: a partial Fisher-Yates shuffle moves each drawn station
+            // past the nbCandidates first ones, so it is not drawn again and
+            // the unvisited stations stay the first nbUnvisited ones
+            int nbCandidates = nbUnvisited;
+            int nextStation = 0;
+            double timeToNextStation = 0;
+            double timeToDepot = 0;
+            while (nbCandidates > 0) {
+                int drawn = static_cast<int>(params.ran() % nbCandidates);
+                std::swap(unVisited[drawn], unVisited[--nbCandidates]);
+                int candidate = unVisited[nbCandidates];
+                timeToNextStation = instance.rpm_dist_mtx(curStation, candidate);
+                timeToDepot = instance.rpm_dist_mtx(candidate, 0);
+                if (remainingTime - timeToNextStation - timeToDepot >= params.repairTime) {
+                    nextStation = candidate;
+                    break;
+                }
             }
-            // if the loop exit with stationCandidates not empty, we find a station to
-            // repair
-            if (!stationCandidates.empty()) {
+            // if a candidate was found, we repair at this station
+            if (nextStation != 0) {
                 remainingTime -= timeToNextStation;
                 remainingTime -= timeToDepot;
                 int repairQuantity = std::min(
                     instance.networkInfo[nextStation].brokenBike, TimeHelper::maxRepairQByTime(params, remainingTime));
-                remainingTime -= instance.dist_mtx[curStation][nextStation] + params.repairTime * repairQuantity;
+                remainingTime -= instance.dist_mtx(curStation, nextStation) + params.repairTime * repairQuantity;
                 curBroken[nextStation] -= repairQuantity;
                 curUsable[nextStation] += repairQuantity;
                 // update the current station
                 curStation = nextStation;
                 rpmVector[i].push_back(nextStation);
-                // update the visited list
-                unVisited.erase(nextStation);
+                // update the visited list, nextStation is at position nbCandidates
+                std::swap(unVisited[nbCandidates], unVisited[--nbUnvisited]);
                 remainingTime += timeToDepot;
             } else {
                 rpmVector[i].push_back(0);
@@ -160,10 +237,13 @@ void Individual::trkRouteInit(Params &params, std::vector<std::vector<int>> &trk
             double remainingTimeBak = remainingTime;
             int truckUsablePrevBak = truckUsablePrev;
             int truckBrokenPrevBak = truckBrokenPrev;
-            for (int j = 1; j <= params.nbClients; j++) {
-                if (j == curStation) { continue; }
-                remainingTime -= instance.dist_mtx[curStation][j];
-                remainingTime -= instance.dist_mtx[j][0];
+            // the candidate stations are the closest ones to the current
+            // station when the neighbor lists are computed, all of them
+            // otherwise or when none of the closest is reachable
+            auto addCandidate = [&](int j) {
+                if (j == curStation) { return; }
+                remainingTime -= instance.dist_mtx(curStation, j);
+                remainingTime -= instance.dist_mtx(j, 0);
                 // check the status of the station
                 if (curUsable[j] <= instance.networkInfo[j].targetUsable) {
                     int maxDeliveryQuantityU;
@@ -214,11 +294,17 @@ void Individual::trkRouteInit(Params &params, std::vector<std::vector<int>> &trk
                 remainingTime = remainingTimeBak;
                 truckUsablePrev = truckUsablePrevBak;
                 truckBrokenPrev = truckBrokenPrevBak;
+            };
+            for (int r = 0; r < instance.nbNeighbors(); r++) {
+                addCandidate(instance.nearestSuccessors(curStation, r));
+            }
+            if (reachableList.empty()) {
+                for (int j = 1; j <= params.nbClients; j++) { addCandidate(j); }
             }
 
             if (reachableList.empty()) {
                 if (remainingTime > 0 && curStation != 0) {
-                    remainingTime -= instance.dist_mtx[curStation][0];
+                    remainingTime -= instance.dist_mtx(curStation, 0);
                     truckBrokenPrev = 0;
                     truckUsablePrev = 0;
                     trkVector[i].push_back(0);
@@ -244,7 +330,7 @@ void Individual::trkRouteInit(Params &params, std::vector<std::vector<int>> &trk
                 int collectionQuantityB = reachableList[selectedStationIdx].collectionQuantityB;
                 // add the selected station to the route
                 trkVector[i].push_back(selectedStation);
-                remainingTime -= instance.dist_mtx[curStation][selectedStation]
+                remainingTime -= instance.dist_mtx(curStation, selectedStation)
                                  + params.loadingTime * (collectionQuantityU + collectionQuantityB);
                 // update the inventories of usable and broken bikes
                 curUsable[selectedStation] += deliveryQuantityU - collectionQuantityU;
@@ -269,68 +355,136 @@ void Individual::trkRouteInit(Params &params, std::vector<std::vector<int>> &trk
 }
 
 void Individual::greedyAssignmentForTrucks(Params &params, std::vector<int> &curUsable, std::vector<int> &curBroken,
-    std::vector<std::vector<int>> &trkVector, Instance &instance) {
-    std::vector<std::vector<RSchemeT>> repositionSchemeOverallVector;
+    std::vector<std::vector<int>> &trkVector, Instance &instance, BuildTrace &newTrace, const BuildTrace *reference) {
     // backup the current inventory
-    std::vector<int> curUsableBak = curUsable;
-    std::vector<int> curBrokenBak = curBroken;
-    for (int i = 0; i < params.nbVehicles; i++) {
-        std::vector<RSchemeT> newScheme = assignTruckScheme(params, trkVector[i], curUsable, curBroken, instance);
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    std::vector<int> &curUsableBak = workspace.usableBak;
+    std::vector<int> &curBrokenBak = workspace.brokenBak;
+    curUsableBak = curUsable;
+    curBrokenBak = curBroken;
+    // the trucks start from the inventories left by the repairmen, so the
+    // reference is only valid if all the repairmen were assigned as in it
+    std::size_t nbReused = reference == nullptr || newTrace.repairmen != reference->repairmen
+                               ? 0
+                               : nbReusable(reference->trucks, trkVector);
+    // the schemes are assigned in place, so that rebuilding an individual
+    // reuses their capacity
+    repositionSchemeVectorTruck.resize(params.nbVehicles);
+    for (std::size_t i = 0; i < nbReused; i++) {
+        const auto &assignment = reference->trucks[i];
+        trkVector[i] = assignment->chromosome;
+        repositionSchemeVectorTruck[i] = assignment->scheme;
+        newTrace.trucks.push_back(assignment);
+    }
+    if (nbReused > 0) { restoreInventory(newTrace.trucks.back()->inventory, curUsable, curBroken); }
+    for (int i = static_cast<int>(nbReused); i < params.nbVehicles; i++) {
+        std::shared_ptr<RouteAssignment<RSchemeT>> assignment = newRouteAssignment<RSchemeT>();
+        std::vector<RSchemeT> &newScheme = repositionSchemeVectorTruck[i];
+        assignment->route = trkVector[i];
+        assignTruckScheme(params, trkVector[i], curUsable, curBroken, instance, newScheme);
         fixZeroLoading(curUsableBak, curBrokenBak, params, curUsable, curBroken, trkVector[i], instance, newScheme);
-        repositionSchemeVectorTruck.push_back(newScheme);
+        assignment->chromosome = trkVector[i];
+        assignment->scheme = newScheme;
+        inventoryAfter(newTrace, assignment->route, curUsable, curBroken, assignment->inventory);
+        newTrace.trucks.push_back(std::move(assignment));
     }
 }
 void Individual::fixZeroLoading(std::vector<int> &curUsableBak, std::vector<int> &curBrokenBak, Params &params,
     std::vector<int> &curUsable, std::vector<int> &curBroken, std::vector<int> &trkVector, Instance &instance,
     std::vector<RSchemeT> &newScheme) {
     // Use find_if to determine if there is any element with all quantities zero
-    auto zeroLoadingIt = std::find_if(newScheme.begin() + 1, newScheme.end() - 1, [](const RSchemeT scheme) {
-        return scheme->loadingQuantityU == 0 && scheme->loadingQuantityB == 0 &&
-               scheme->unloadingQuantityU == 0 && scheme->unloadingQuantityB == 0;
-    });
+    auto zeroLoading = [](const RSchemeT &scheme) {
+        return scheme.loadingQuantityU == 0 && scheme.loadingQuantityB == 0 &&
+               scheme.unloadingQuantityU == 0 && scheme.unloadingQuantityB == 0;
+    };
+    auto zeroLoadingIt = std::find_if(newScheme.begin() + 1, newScheme.end() - 1, zeroLoading);
 
-    if (zeroLoadingIt != newScheme.end() - 1) {
+    if (zeroLoadingIt != newScheme.end() - 1 && params.ap.singlePassAssignment) {
+        // the stops are dropped instead of assigning the route again, the time
+        // they leave is spent by truckSchemeAmendment
+        dropIdleStops(newScheme, trkVector, zeroLoading);
+    } else if (zeroLoadingIt != newScheme.end() - 1) {
         // Use remove_if to filter out elements with all quantities zero and copy the rest to trkVector[i]
         trkVector = {0}; // Initialize with 0
         for (auto it = newScheme.begin() + 1; it != newScheme.end() - 1; ++it) {
-            if (!((*it)->loadingQuantityU == 0 && (*it)->loadingQuantityB == 0 &&
-                    (*it)->unloadingQuantityU == 0 && (*it)->unloadingQuantityB == 0)) {
-                trkVector.push_back((*it)->station);
+            if (!(it->loadingQuantityU == 0 && it->loadingQuantityB == 0 &&
+                    it->unloadingQuantityU == 0 && it->unloadingQuantityB == 0)) {
+                trkVector.push_back(it->station);
             }
         }
         trkVector.push_back(0);
             curUsable = curUsableBak;
             curBroken = curBrokenBak;
-            newScheme = assignTruckScheme(params, trkVector, curUsable, curBroken, instance);
+            assignTruckScheme(params, trkVector, curUsable, curBroken, instance, newScheme);
     }
 }
 
 void Individual::greedyAssignmentForRepairman(Params &params, std::vector<int> &curUsable, std::vector<int> &curBroken,
-    std::vector<std::vector<int>> &rpmVector, Instance &instance) {
-    std::vector<std::vector<RSchemeR>> repositionSchemeOverallVector;
+    std::vector<std::vector<int>> &rpmVector, Instance &instance, BuildTrace &newTrace, const BuildTrace *reference) {
     // backup the current inventory
-    std::vector<int> curUsableBak = curUsable;
-    std::vector<int> curBrokenBak = curBroken;
-    for (int i = 0; i < params.nbRepairmen; i++) {
-        std::vector<RSchemeR> newScheme = assignRepairmanScheme(params, rpmVector[i], curUsable, curBroken, instance);
-        bool containsZeroRepair = false;
-        rpmVector[i] = {0};
-        for (int j = 1; j < newScheme.size() - 1; j++) {
-            if (newScheme[j]->repairingQuantity == 0) {
-                containsZeroRepair = true;
-            } else {
-                rpmVector[i].push_back(newScheme[j]->station);
-            }
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    std::vector<int> &curUsableBak = workspace.usableBak;
+    std::vector<int> &curBrokenBak = workspace.brokenBak;
+    curUsableBak = curUsable;
+    curBrokenBak = curBroken;
+    // the routes before the first one that changed are assigned as in the
+    // reference, and leave the inventories it recorded
+    const RepairmenAssignment *reused = reference == nullptr ? nullptr : &reference->repairmen;
+    std::size_t nbReused = reused == nullptr ? 0 : nbReusable(*reused, rpmVector);
+    // otherwise the whole assignment may have been cached by another build,
+    // as it only depends on the routes
+    bool cached = false;
+    if (nbReused < static_cast<std::size_t>(params.nbRepairmen)) {
+        if (const RepairmenAssignment *entry = params.repairmanCache.find(rpmVector)) {
+            reused = entry;
+            nbReused = entry->size();
+            cached = true;
         }
-        rpmVector[i].push_back(0);
+    }
+    repositionSchemeVectorRepairman.resize(params.nbRepairmen);
+    for (std::size_t i = 0; i < nbReused; i++) {
+        const auto &assignment = (*reused)[i];
+        rpmVector[i] = assignment->chromosome;
+        repositionSchemeVectorRepairman[i] = assignment->scheme;
+        newTrace.repairmen.push_back(assignment);
+    }
+    if (nbReused > 0) { restoreInventory(newTrace.repairmen.back()->inventory, curUsable, curBroken); }
+    for (int i = static_cast<int>(nbReused); i < params.nbRepairmen; i++) {
+        std::shared_ptr<RouteAssignment<RSchemeR>> assignment = newRouteAssignment<RSchemeR>();
+        std::vector<RSchemeR> &newScheme = repositionSchemeVectorRepairman[i];
+        assignment->route = rpmVector[i];
+        assignRepairmanScheme(params, rpmVector[i], curUsable, curBroken, instance, newScheme);
+        if (params.ap.singlePassAssignment) {
+            // the stops without repair are dropped, the time they leave is
+            // spent by repairmanSchemeAmendment
+            dropIdleStops(
+                newScheme, rpmVector[i], [](const RSchemeR &scheme) { return scheme.repairingQuantity == 0; });
+        } else {
+            bool containsZeroRepair = false;
+            rpmVector[i] = {0};
+            for (int j = 1; j < newScheme.size() - 1; j++) {
+                if (newScheme[j].repairingQuantity == 0) {
+                    containsZeroRepair = true;
+                } else {
+                    rpmVector[i].push_back(newScheme[j].station);
+                }
+            }
+            rpmVector[i].push_back(0);
 
-        if (containsZeroRepair) {
-            curUsable = curUsableBak;
-            curBroken = curBrokenBak;
-            newScheme = assignRepairmanScheme(params, rpmVector[i], curUsable, curBroken, instance);
+            if (containsZeroRepair) {
+                curUsable = curUsableBak;
+                curBroken = curBrokenBak;
+                assignRepairmanScheme(params, rpmVector[i], curUsable, curBroken, instance, newScheme);
+            }
         }
 
-        repositionSchemeVectorRepairman.push_back(newScheme);
+        assignment->chromosome = rpmVector[i];
+        assignment->scheme = newScheme;
+        inventoryAfter(newTrace, assignment->route, curUsable, curBroken, assignment->inventory);
+        newTrace.repairmen.push_back(std::move(assignment));
+    }
+    if (!cached && nbReused < static_cast<std::size_t>(params.nbRepairmen)) {
+        params.repairmanCache.insert(newTrace.repairmen);
     }
 }
 
@@ -343,125 +497,217 @@ void Individual::feasibilityCheckOfSolution(Params &params, Instance &instance)
     this->eval.routeRPM = 0;
     this->eval.operationTimeRPM = 0;
     this->eval.isFeasible = true;
-    this->eval.dissatisFaction = {};
-    std::vector<int> initialUsable = {};
-    std::vector<int> initialBroken = {};
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    std::vector<int> &initialUsable = workspace.finalUsable;
+    std::vector<int> &initialBroken = workspace.finalBroken;
+    initialUsable.clear();
+    initialBroken.clear();
     for (int i = 0; i <= params.nbClients; i++) {
         initialUsable.push_back(instance.networkInfo[i].usableBike);
         initialBroken.push_back(instance.networkInfo[i].brokenBike);
     }
     // traverse each reposition scheme and calculate the arriving time at each
     // station, mark the arriving time at the corresponding field of the
-    // reposition scheme
-    std::vector<RScheme> combinedFlattenedScheme = {};
+    // reposition scheme and record the visits of each route
+    std::size_t nbEvents = 0;
+    for (auto &trkScheme : repositionSchemeVectorTruck) { nbEvents += trkScheme.size(); }
+    for (auto &rpmScheme : repositionSchemeVectorRepairman) { nbEvents += rpmScheme.size(); }
+    std::vector<RepositionEvent> &routeEvents = workspace.routeEvents;
+    routeEvents.clear();
+    routeEvents.reserve(nbEvents);
+    // routeEvents[routeBounds[r]] .. routeEvents[routeBounds[r + 1] - 1] are the visits of route r
+    std::vector<std::size_t> &routeBounds = workspace.routeBounds;
+    routeBounds.assign(1, 0);
     // for truck
     for (auto &trkScheme : repositionSchemeVectorTruck) {
         double arrivingTime = 0;
         int prevStation = 0;
-        trkScheme[0]->arrivingTime = 0;
+        trkScheme[0].arrivingTime = 0;
         double emission = 0;
         double routeTimeTRK = 0;
         double operationTimeTRK
-            = params.loadingTime * (trkScheme[0]->loadingQuantityU + trkScheme[0]->loadingQuantityB);
+            = params.loadingTime * (trkScheme[0].loadingQuantityU + trkScheme[0].loadingQuantityB);
 
-        arrivingTime += params.loadingTime * (trkScheme[0]->loadingQuantityU + trkScheme[0]->loadingQuantityB);
-        std::vector<RSchemeT> updatedSchemeTRK;
-        updatedSchemeTRK.push_back(trkScheme[0]);
+        arrivingTime += params.loadingTime * (trkScheme[0].loadingQuantityU + trkScheme[0].loadingQuantityB);
         // displayAnIndividual();
         for (int j = 1; j < trkScheme.size(); j++) {
-            int curStation = trkScheme[j]->station;
-            int loadingU = trkScheme[j]->loadingQuantityU;
-            int loadingB = trkScheme[j]->loadingQuantityB;
-            int unloadingU = trkScheme[j]->unloadingQuantityU;
-            int unloadingB = trkScheme[j]->unloadingQuantityB;
-            arrivingTime += instance.dist_mtx[prevStation][curStation];
-            trkScheme[j]->arrivingTime = arrivingTime;
+            int curStation = trkScheme[j].station;
+            int loadingU = trkScheme[j].loadingQuantityU;
+            int loadingB = trkScheme[j].loadingQuantityB;
+            int unloadingU = trkScheme[j].unloadingQuantityU;
+            int unloadingB = trkScheme[j].unloadingQuantityB;
+            arrivingTime += instance.dist_mtx(prevStation, curStation);
+            trkScheme[j].arrivingTime = arrivingTime;
             arrivingTime += params.loadingTime * (loadingU + loadingB + unloadingU + unloadingB);
-            combinedFlattenedScheme.push_back(trkScheme[j]);
-            emission += 2.61 * (0.252 + 0.0003 * (trkScheme[j - 1]->truckBQ + trkScheme[j - 1]->truckUQ))
-                        * instance.dist_mtx[prevStation][curStation] / 60.0 * 0.42;
-            routeTimeTRK += instance.dist_mtx[prevStation][curStation];
+            routeEvents.emplace_back(trkScheme[j]);
+            emission += 2.61 * (0.252 + 0.0003 * (trkScheme[j - 1].truckBQ + trkScheme[j - 1].truckUQ))
+                        * instance.dist_mtx(prevStation, curStation) / 60.0 * 0.42;
+            routeTimeTRK += instance.dist_mtx(prevStation, curStation);
             operationTimeTRK += params.loadingTime * (loadingU + loadingB + unloadingU + unloadingB);
             prevStation = curStation;
-            updatedSchemeTRK.push_back(trkScheme[j]);
         }
         this->eval.emission += emission;
         this->eval.routeTRK += routeTimeTRK;
         this->eval.operationTimeTRK += operationTimeTRK;
-        trkScheme = updatedSchemeTRK;
+        routeBounds.push_back(routeEvents.size());
     }
     // for repairman
     for (auto &rpmScheme : repositionSchemeVectorRepairman) {
         double arrivingTime = 0;
         int prevStation = 0;
-        rpmScheme[0]->arrivingTime = 0;
+        rpmScheme[0].arrivingTime = 0;
         double routeTimeRPM = 0;
         double operationTimeRPM = 0.;
-        std::vector<RSchemeR> updatedSchemeRPM;
-        updatedSchemeRPM.push_back(rpmScheme[0]);
         for (int j = 1; j < rpmScheme.size(); j++) {
-            arrivingTime += instance.dist_mtx[prevStation][rpmScheme[j]->station] * 1.68;
-            rpmScheme[j]->arrivingTime = arrivingTime;
-            double repairTime = params.repairTime * rpmScheme[j]->repairingQuantity;
+            arrivingTime += instance.rpm_dist_mtx(prevStation, rpmScheme[j].station);
+            rpmScheme[j].arrivingTime = arrivingTime;
+            double repairTime = params.repairTime * rpmScheme[j].repairingQuantity;
             arrivingTime += repairTime;
-            routeTimeRPM += instance.dist_mtx[prevStation][rpmScheme[j]->station] * 1.68;
+            routeTimeRPM += instance.rpm_dist_mtx(prevStation, rpmScheme[j].station);
             operationTimeRPM += repairTime;
-            prevStation = rpmScheme[j]->station;
-            combinedFlattenedScheme.push_back(rpmScheme[j]);
-            updatedSchemeRPM.push_back(rpmScheme[j]);
+            prevStation = rpmScheme[j].station;
+            routeEvents.emplace_back(rpmScheme[j]);
         }
         this->eval.routeRPM += routeTimeRPM;
         this->eval.operationTimeRPM += operationTimeRPM;
-        rpmScheme = updatedSchemeRPM;
+        routeBounds.push_back(routeEvents.size());
     }
-    // print the combinedFlattenedScheme
-
-    // sort the combinedFlattenedScheme by the arriving time
-    std::sort(combinedFlattenedScheme.begin(), combinedFlattenedScheme.end(),
-        [](const RScheme &a, const RScheme &b) { return a->arrivingTime < b->arrivingTime; });
-    // traverse the combinedFlattenedScheme and perform the
-    // loading/unloading/repairing operation to check whether a station's:
+    // a station's inventory only depends on the order of the visits to that
+    // station. The visits of a station served by a single route come in route
+    // order, which is time order, so only the stations shared by several routes
+    // need their visits ordered by arriving time
+    constexpr int sharedStation = -2;
+    std::vector<int> &owner = workspace.owner; // route visiting the station, or sharedStation
+    std::vector<int> &visitedStations = workspace.visitedStations;
+    owner.assign(params.nbClients + 1, -1);
+    visitedStations.clear();
+    for (std::size_t r = 0; r + 1 < routeBounds.size(); r++) {
+        for (std::size_t k = routeBounds[r]; k < routeBounds[r + 1]; k++) {
+            int &stationOwner = owner[routeEvents[k].station];
+            if (stationOwner == -1) {
+                stationOwner = static_cast<int>(r);
+                if (routeEvents[k].station != 0) { visitedStations.push_back(routeEvents[k].station); }
+            } else if (stationOwner != static_cast<int>(r)) {
+                stationOwner = sharedStation;
+            }
+        }
+    }
+    // perform the loading/unloading/repairing operation of a visit and check
+    // whether the station's:
     // 1. usable inv + broken inv > capacity
     // 2. usable inv < 0
     // 3. broken inv < 0
-    // notice for scheme with usableLoad is -1, it is a repairman scheme, and we
-    // only need to perform repair using the repairingQuantity; for other scheme,
-    // we need to perform loading and unloading of usable and broken bikes
-    for (auto &comScheme : combinedFlattenedScheme) {
-        int curStation = comScheme->station;
-        if (curStation != 0) {
-            if (auto rpmPtr = dynamic_cast<RepositionSchemeRPM *>(comScheme.get())) {
-                initialUsable[curStation] += rpmPtr->repairingQuantity;
-                initialBroken[curStation] -= rpmPtr->repairingQuantity;
-            } else {
-                if (auto trkPtr = dynamic_cast<RepositionSchemeTRK *>(comScheme.get())) {
-                    initialUsable[curStation] -= trkPtr->loadingQuantityU;
-                    initialBroken[curStation] -= trkPtr->loadingQuantityB;
-                    initialUsable[curStation] += trkPtr->unloadingQuantityU;
-                    initialBroken[curStation] += trkPtr->unloadingQuantityB;
-                }
-            }
-            if (initialUsable[curStation] < 0 || initialBroken[curStation] < 0
-                || initialUsable[curStation] + initialBroken[curStation] > instance.networkInfo[curStation].capacity) {
-                eval.isFeasible = false;
-                eval.capacityExcess -= std::min(initialUsable[curStation], 0) + std::min(initialBroken[curStation], 0)
-                                       + std::min(instance.networkInfo[curStation].capacity - initialUsable[curStation]
-                                                      - initialBroken[curStation],
-                                           0);
-            }
+    // each visit carries its inventory change: the repaired bikes of a
+    // repairman, or the loading and unloading of usable and broken bikes of a truck
+    auto performVisit = [&](const RepositionEvent &visit) {
+        int curStation = visit.station;
+        initialUsable[curStation] += visit.usableChange;
+        initialBroken[curStation] += visit.brokenChange;
+        if (initialUsable[curStation] < 0 || initialBroken[curStation] < 0
+            || initialUsable[curStation] + initialBroken[curStation] > instance.networkInfo[curStation].capacity) {
+            eval.isFeasible = false;
+            eval.capacityExcess -= std::min(initialUsable[curStation], 0) + std::min(initialBroken[curStation], 0)
+                                   + std::min(instance.networkInfo[curStation].capacity - initialUsable[curStation]
+                                                  - initialBroken[curStation],
+                                       0);
+        }
+    };
+    // indices in routeEvents of the visits at shared stations
+    std::vector<std::size_t> &sharedVisits = workspace.sharedVisits;
+    sharedVisits.clear();
+    for (std::size_t k = 0; k < routeEvents.size(); k++) {
+        const RepositionEvent &visit = routeEvents[k];
+        if (visit.station == 0) { continue; }
+        if (owner[visit.station] == sharedStation) {
+            sharedVisits.push_back(k);
+        } else {
+            performVisit(visit);
         }
     }
+    // ties on the arriving time are broken by the index, so visits at the same
+    // time keep the route order as a stable sort would, without its buffer
+    std::sort(sharedVisits.begin(), sharedVisits.end(), [&routeEvents](std::size_t a, std::size_t b) {
+        const RepositionEvent &first = routeEvents[a], &second = routeEvents[b];
+        if (first.station != second.station) { return first.station < second.station; }
+        if (first.arrivingTime != second.arrivingTime) { return first.arrivingTime < second.arrivingTime; }
+        return a < b;
+    });
+    for (std::size_t k : sharedVisits) { performVisit(routeEvents[k]); }
+    // the stations no route visits keep their initial dissatisfaction, which
+    // the instance sums once, so only the visited stations are looked up
     if (eval.isFeasible) {
-        for (int i = 1; i <= params.nbClients; i++) {
+        this->eval.dissat = instance.baselineDissat;
+        for (int i : visitedStations) {
+            this->eval.dissat -= instance.initialDissat[i];
             if (initialUsable[i] >= 0 && initialBroken[i] >= 0
                 && initialUsable[i] + initialBroken[i] <= instance.networkInfo[i].capacity) {
-                this->eval.dissat += instance.dissatTable[i][initialUsable[i]][initialBroken[i]];
-                this->eval.dissatisFaction.push_back(instance.dissatTable[i][initialUsable[i]][initialBroken[i]]);
+                this->eval.dissat += instance.dissatTable(i, initialUsable[i], initialBroken[i]);
             }
         }
     }
 }
 
+std::vector<double> Individual::dissatByStation(const Instance &instance) const {
+    std::vector<double> dissatisfaction;
+    if (!eval.isFeasible) { return dissatisfaction; }
+    // the final inventory of a station does not depend on the order of the visits
+    std::vector<int> finalUsable(instance.nbClients + 1), finalBroken(instance.nbClients + 1);
+    for (int i = 1; i <= instance.nbClients; i++) {
+        finalUsable[i] = instance.networkInfo[i].usableBike;
+        finalBroken[i] = instance.networkInfo[i].brokenBike;
+    }
+    auto performVisit = [&](const RepositionEvent &visit) {
+        if (visit.station == 0) { return; }
+        finalUsable[visit.station] += visit.usableChange;
+        finalBroken[visit.station] += visit.brokenChange;
+    };
+    for (const auto &trkScheme : repositionSchemeVectorTruck) {
+        for (const auto &visit : trkScheme) { performVisit(RepositionEvent(visit)); }
+    }
+    for (const auto &rpmScheme : repositionSchemeVectorRepairman) {
+        for (const auto &visit : rpmScheme) { performVisit(RepositionEvent(visit)); }
+    }
+    for (int i = 1; i <= instance.nbClients; i++) {
+        if (finalUsable[i] >= 0 && finalBroken[i] >= 0
+            && finalUsable[i] + finalBroken[i] <= instance.networkInfo[i].capacity) {
+            dissatisfaction.push_back(instance.dissatTable(i, finalUsable[i], finalBroken[i]));
+        }
+    }
+    return dissatisfaction;
+}
+
+Individual Individual::withoutSchemes() const {
+    Individual lean;
+    lean.eval = eval;
+    lean.chromRPM = chromRPM;
+    lean.chromTRK = chromTRK;
+    if (!hasSchemes() || trace == nullptr) {
+        lean.sourceRPM = sourceRPM;
+        lean.sourceTRK = sourceTRK;
+        return lean;
+    }
+    // the traced routes are the ones the schemes were assigned from
+    for (const auto &assignment : trace->repairmen) { lean.sourceRPM.push_back(assignment->route); }
+    for (const auto &assignment : trace->trucks) { lean.sourceTRK.push_back(assignment->route); }
+    return lean;
+}
+
+void Individual::materializeSchemes(Params &params, Instance &instance) {
+    if (hasSchemes()) { return; }
+    EvalIndiv evalBak = eval;
+    chromRPM = std::move(sourceRPM);
+    chromTRK = std::move(sourceTRK);
+    sourceRPM.clear();
+    sourceTRK.clear();
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    workspace.usable.assign(params.nbClients + 1, 0);
+    workspace.broken.assign(params.nbClients + 1, 0);
+    buildIndividual(params, workspace.usable, workspace.broken, instance);
+    // keep the population ranks and the objective under the penalty it was
+    // evaluated with
+    eval = evalBak;
+}
+
 void Individual::solutionEvaluation(Params &params) {
     this->eval.objVal = 2 * this->eval.dissat + 0.06 * this->eval.emission
                         + 1e-8
@@ -470,24 +716,24 @@ void Individual::solutionEvaluation(Params &params) {
                         + params.ap.penaltyCapacity * this->eval.capacityExcess;
 }
 
-void Individual::displayAnIndividual() {
+void Individual::displayAnIndividual(const Instance &instance) {
     std::cout << "repositioning scheme for truck" << std::endl;
     for (auto &scheme : repositionSchemeVectorTruck) {
         std::cout << "=======" << std::endl;
         for (auto &subscheme : scheme) {
-            std::cout << subscheme->station << "\t";
-            std::cout << "load " << subscheme->loadingQuantityU << " usable bikes;";
-            std::cout << "load " << subscheme->loadingQuantityB << " broken bikes;";
-            std::cout << "unload " << subscheme->unloadingQuantityU << " usable bikes;";
-            std::cout << "unload " << subscheme->unloadingQuantityB << " broken bikes" << std::endl;
+            std::cout << subscheme.station << "\t";
+            std::cout << "load " << subscheme.loadingQuantityU << " usable bikes;";
+            std::cout << "load " << subscheme.loadingQuantityB << " broken bikes;";
+            std::cout << "unload " << subscheme.unloadingQuantityU << " usable bikes;";
+            std::cout << "unload " << subscheme.unloadingQuantityB << " broken bikes" << std::endl;
         }
     }
     std::cout << "repositioning scheme for repairman" << std::endl;
     for (auto &scheme : repositionSchemeVectorRepairman) {
         std::cout << "=======" << std::endl;
         for (auto &subscheme : scheme) {
-            std::cout << subscheme->station << "\t";
-            std::cout << "repair " << subscheme->repairingQuantity << " bikes" << std::endl;
+            std::cout << subscheme.station << "\t";
+            std::cout << "repair " << subscheme.repairingQuantity << " bikes" << std::endl;
         }
     }
     std::cout << std::endl;
@@ -501,7 +747,8 @@ void Individual::displayAnIndividual() {
     std::cout << "individual's rpmOperationTime: " << eval.operationTimeRPM << std::endl;
 
     std::cout << "dissat at each station" << std::endl;
-    for (int i = 1; i <= eval.dissatisFaction.size(); i++) {
-        std::cout << "dissat[" << i << "] = " << eval.dissatisFaction[i - 1] << std::endl;
+    std::vector<double> dissatisfaction = dissatByStation(instance);
+    for (int i = 1; i <= dissatisfaction.size(); i++) {
+        std::cout << "dissat[" << i << "] = " << dissatisfaction[i - 1] << std::endl;
     }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BuildTrace.h"
 #include "Instance.h"
 #include "Params.h"
 #include "helpers/Utils.h"
@@ -19,7 +20,6 @@ struct EvalIndiv {
   double routeRPM = 0.;
   double operationTimeTRK = 0.;
   double operationTimeRPM = 0.;
-  std::vector<double> dissatisFaction{0};
 };
 
 class Individual {
@@ -33,16 +33,27 @@ public:
                 // (complete solution)
   std::vector<std::vector<RSchemeT>> repositionSchemeVectorTruck;
   std::vector<std::vector<RSchemeR>> repositionSchemeVectorRepairman;
+  std::shared_ptr<const BuildTrace> trace; // route assignments of the build
+  // routes the schemes were built from, only kept by a copy without schemes
+  // (see withoutSchemes)
+  std::vector<std::vector<int>> sourceRPM;
+  std::vector<std::vector<int>> sourceTRK;
 
   // Constructor of a random individual containing only a giant tour with a
   // shuffled visit order
   Individual();
   Individual(Params &params, Instance &instance);
+  // Individual with the given routes. With a reference trace (usually the
+  // trace of the individual a move started from), the route assignments are
+  // only redone from the first route that differs from the reference, the
+  // result is the same as a full build
   Individual(Params &params, Instance &instance,
              const std::vector<std::vector<int>> &rpmRoutes,
-             const std::vector<std::vector<int>> &trkRoutes);
+             const std::vector<std::vector<int>> &trkRoutes,
+             const BuildTrace *reference = nullptr);
   void buildIndividual(Params &params, std::vector<int> &curUsable,
-                       std::vector<int> &curBroken, Instance &instance);
+                       std::vector<int> &curBroken, Instance &instance,
+                       const BuildTrace *reference = nullptr);
   static void trkRouteInit(Params &params,
                            std::vector<std::vector<int>> &trkVector,
                            std::vector<int> &curUsable,
@@ -54,14 +65,28 @@ public:
   void greedyAssignmentForTrucks(Params &params, std::vector<int> &curUsable,
                                  std::vector<int> &curBroken,
                                  std::vector<std::vector<int>> &trkVector,
-                                 Instance &instance);
+                                 Instance &instance, BuildTrace &newTrace,
+                                 const BuildTrace *reference);
   void solutionEvaluation(Params &params);
   void greedyAssignmentForRepairman(Params &params, std::vector<int> &curUsable,
                                     std::vector<int> &curBroken,
                                     std::vector<std::vector<int>> &rpmVector,
-                                    Instance &instance);
+                                    Instance &instance, BuildTrace &newTrace,
+                                    const BuildTrace *reference);
   void feasibilityCheckOfSolution(Params &params, Instance &instance);
-  void displayAnIndividual();
+  // Dissatisfaction of each station with a valid final inventory, in station
+  // order (empty for an infeasible solution); rebuilt from the schemes, only
+  // meant for reporting the final solution
+  std::vector<double> dissatByStation(const Instance &instance) const;
+  void displayAnIndividual(const Instance &instance);
+  // Copy holding the chromosomes and the evaluation but neither the schemes nor
+  // the build trace, only the routes to rebuild them from, for the individuals
+  // kept in the population (params.ap.leanIndividuals)
+  Individual withoutSchemes() const;
+  bool hasSchemes() const { return sourceRPM.empty() && sourceTRK.empty(); }
+  // Rebuilds the schemes of a copy without schemes, the same as when the
+  // individual was first built
+  void materializeSchemes(Params &params, Instance &instance);
   bool operator==(const Individual &other) const {
     // Two Individuals are considered equal if their 'chromRPM' and 'chromTRK'
     // members are equal.
@@ -3,143 +3,268 @@
 //
 
 #include "Instance.h"
+#include "helpers/BinaryHelper.h"
+#include "helpers/NumberReader.h"
+#include "helpers/ShmHelper.h"
+#include "helpers/ThreadHelper.h"
 #include <cmath>
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
-Instance::Instance(int nbClient, const std::string &instNo, double proportion, bool expIsProportion) {
-    std::string pathToInstance
-        = "../Instances/" + std::to_string(nbClient) + "_" + instNo + "/";
+Instance::Instance(int nbClient, const std::string &instNo, double proportion, bool expIsProportion, bool useBinary,
+    int nbLoadThreads, bool useShared) {
+    pathToInstance = "../Instances/" + std::to_string(nbClient) + "_" + instNo + "/";
     isProportion = expIsProportion;
     nbClients = nbClient;
     proportionRatio = proportion;
 
-    readMatrixFromFile(pathToInstance);
-    readStationInfoFromFile(pathToInstance, isProportion);
-    readDissatisTable(pathToInstance);
-    readPriorityTable(pathToInstance);
-    readPriorityTableR(pathToInstance);
+    bool loaded = (useShared && ShmHelper::loadShared(*this, instNo, useBinary, nbLoadThreads))
+                  || (useBinary && BinaryHelper::readImage(*this, binaryPath()));
+    if (!loaded) {
+        readMatrixFromFile(pathToInstance);
+        readStationInfoFromFile(pathToInstance, isProportion);
+        if (ThreadHelper::resolveThreadCount(nbLoadThreads) > 1) {
+            readStationTablesParallel(pathToInstance, nbLoadThreads);
+        } else {
+            readDissatisTable(pathToInstance);
+            readPriorityTable(pathToInstance);
+            readPriorityTableR(pathToInstance);
+        }
+    }
+    computeBaselineDissat();
+    computeBestRepair();
+}
+
+std::string Instance::binaryPath() const { return pathToInstance + "instance_" + std::to_string(nbClients) + ".bin"; }
+
+// appends the next station to networkInfo, deriving the broken bikes from the proportion ratio if required
+void Instance::addStation(int capacity, int usableBike, int targetUsable, int brokenBike) {
+    int id = static_cast<int>(networkInfo.size());
+    if (isProportion) {
+        if (usableBike > targetUsable) {
+            brokenBike = 0;
+        } else {
+            brokenBike = ceil(proportionRatio * (targetUsable - usableBike));
+            brokenBike = std::min(brokenBike, capacity - usableBike);
+        }
+    }
+    networkInfo.emplace_back(id, usableBike, brokenBike, targetUsable, capacity);
 }
 
 void Instance::readMatrixFromFile(const std::string &filepath) {
-    std::ifstream inputFile(filepath + "time_matrix_" + std::to_string(nbClients) + ".txt");
-
-    if (inputFile.is_open()) {
-        std::string line;
-        while (std::getline(inputFile, line)) {
-            std::istringstream iss(line);
-            std::vector<double> row;
-            double temp;
-            while (iss >> temp) { row.push_back(temp); }
-            dist_mtx.push_back(row);
+    NumberReader reader;
+    reader.open(filepath + "time_matrix_" + std::to_string(nbClients) + ".txt");
+    parseMatrix(reader);
+}
+
+void Instance::parseMatrix(NumberReader &reader) {
+    dist_mtx.assign(nbClients + 1, nbClients + 1);
+    for (int i = 0; i <= nbClients; i++) {
+        double *row = dist_mtx.row(i);
+        for (int j = 0; j <= nbClients; j++) { reader.expectInLine(row[j]); }
+        reader.skipLine();
+    }
+    computeRepairmanTimes();
+}
+
+// the repairman matrix is derived, it is neither read from the text files nor stored in the compiled image
+void Instance::computeRepairmanTimes() {
+    rpm_dist_mtx.assign(dist_mtx.nbRows(), dist_mtx.nbCols());
+    const double *truckTimes = dist_mtx.data();
+    double *rpmTimes = rpm_dist_mtx.data();
+    for (std::size_t k = 0; k < dist_mtx.size(); k++) { rpmTimes[k] = truckTimes[k] * repairmanSpeedFactor; }
+}
+
+// dissatisfaction of the stations left as they are, a station with an invalid inventory counts for nothing (as in
+// Individual::feasibilityCheckOfSolution)
+void Instance::computeBaselineDissat() {
+    initialDissat.assign(nbClients + 1, 0.);
+    baselineDissat = 0.;
+    for (int i = 1; i <= nbClients; i++) {
+        const Station &station = networkInfo[i];
+        if (station.usableBike >= 0 && station.brokenBike >= 0
+            && station.usableBike + station.brokenBike <= station.capacity) {
+            initialDissat[i] = dissatTable(i, station.usableBike, station.brokenBike);
+            baselineDissat += initialDissat[i];
         }
-    } else {
-        throw std::runtime_error("Could not open file: " + filepath);
+    }
+}
+
+// the best repair counts are derived, like the repairman matrix they are neither read nor stored in the compiled image
+void Instance::computeBestRepair() { bestRepair.build(networkInfo, dissatTable); }
+
+void Instance::computeNeighbors(int k) {
+    k = std::clamp(k, 0, nbClients - 1);
+    nearestSuccessors.assign(nbClients + 1, k);
+    nearestPredecessors.assign(nbClients + 1, k);
+    if (k == 0) { return; }
+    std::vector<int> stations;
+    for (int i = 0; i <= nbClients; i++) {
+        stations.clear();
+        for (int j = 1; j <= nbClients; j++) {
+            if (j != i) { stations.push_back(j); }
+        }
+        // the closer station first, the smaller index on a tie
+        auto fillClosest = [&](Matrix<int> &lists, auto &&time) {
+            std::partial_sort(stations.begin(), stations.begin() + k, stations.end(), [&](int a, int b) {
+                return time(a) != time(b) ? time(a) < time(b) : a < b;
+            });
+            std::copy(stations.begin(), stations.begin() + k, lists.row(i));
+        };
+        fillClosest(nearestSuccessors, [&](int j) { return dist_mtx(i, j); });
+        fillClosest(nearestPredecessors, [&](int j) { return dist_mtx(j, i); });
     }
 }
 
 void Instance::readStationInfoFromFile(const std::string &filepath, bool proportion) {
+    NumberReader reader;
+    reader.open(filepath + "station_info_" + std::to_string(nbClients) + ".txt");
+    parseStationInfo(reader, proportion);
+}
+
+void Instance::parseStationInfo(NumberReader &reader, bool proportion) {
     networkInfo.reserve(nbClients + 1);
     // insert the depot at the beginning of the vector, with usableBike = inf,
     // brokenBike = 0, targetUsable = inf, capacity = inf
     networkInfo.emplace_back(0, INT_MAX, 0, INT_MAX, INT_MAX);
-    std::ifstream inputFile(filepath + "station_info_" + std::to_string(nbClients) + ".txt");
-    if (inputFile.is_open()) {
-        std::string line;
-        int id = 1;
-        std::getline(inputFile, line); // skip the first line
-        while (std::getline(inputFile, line)) {
-            std::istringstream iss(line);
-            // Read the rest of the numbers
-            int real_id, usableBike, brokenBike, targetUsable, capacity;
-            if (!proportion) {
-                if (iss >> real_id >> capacity >> usableBike >> targetUsable >> brokenBike) {
-                    networkInfo.emplace_back(id, usableBike, brokenBike, targetUsable, capacity);
-                } else {
-                    throw std::runtime_error("Could not read a number from line: " + line);
-                }
-            } else {
-                if (iss >> real_id >> capacity >> usableBike >> targetUsable) {
-                    if (usableBike > targetUsable) {
-                        brokenBike = 0;
-                    } else if (usableBike <= targetUsable) {
-                        brokenBike = ceil(proportionRatio * (targetUsable - usableBike));
-                        brokenBike = std::min(brokenBike, capacity - usableBike);
-                    }
-                    networkInfo.emplace_back(id, usableBike, brokenBike, targetUsable, capacity);
-                } else {
-                    throw std::runtime_error("Could not read a number from line: " + line);
-                }
-            }
-            id++;
-        }
-    } else {
-        throw std::runtime_error("Could not open file: " + filepath);
+    reader.skipLine(); // skip the first line
+    while (!reader.atEnd()) {
+        int real_id, usableBike, brokenBike = 0, targetUsable, capacity;
+        reader.expectInLine(real_id);
+        reader.expectInLine(capacity);
+        reader.expectInLine(usableBike);
+        reader.expectInLine(targetUsable);
+        if (!proportion) { reader.expectInLine(brokenBike); }
+        reader.skipLine();
+        addStation(capacity, usableBike, targetUsable, brokenBike);
     }
 }
 
 void Instance::readDissatisTable(const std::string &filepath) {
-    dissatTable.emplace_back();
-
+    dissatTable.layout(networkInfo);
     for (int i = 1; i <= nbClients; i++) {
-        std::vector<std::vector<double>> data;
-        std::string line;
-        std::ifstream file(filepath + "dissat_table_" + std::to_string(i) + ".txt");
-        if (!file) { std::cerr << "Could not open the file!\n"; }
-        while (std::getline(file, line)) {
-            // Create a string stream for the line
-            std::stringstream ss(line);
-
-            // Create a vector to hold the numbers on this line
-            std::vector<double> row;
-
-            // Read each number from the line
-            double value;
-            while (ss >> value) {
-                // Add the number to the row vector
-                row.push_back(value);
-            }
-
-            // Add the row to the main vector
-            data.push_back(row);
-        }
-        dissatTable.push_back(data);
+        readStationTable(filepath + "dissat_table_" + std::to_string(i) + ".txt", i, dissatTable);
     }
 }
 
 void Instance::readPriorityTable(const std::string &filepath) {
+    priorityTable.layout(networkInfo);
     for (int i = 1; i <= nbClients; ++i) {
-        std::vector<std::vector<double>> curPriorityTable;
-        std::ifstream inFile(filepath + "BCRF_" + std::to_string(i) + ".txt");
-        std::string line;
-        while (std::getline(inFile, line)) {
-            std::istringstream iss(line);
-            std::vector<double> row;
-
-            double value;
-            while (iss >> value) { row.push_back(value); }
-
-            curPriorityTable.push_back(row);
-        }
-        priorityTable.push_back(curPriorityTable);
+        readStationTable(filepath + "BCRF_" + std::to_string(i) + ".txt", i, priorityTable);
     }
 }
 
 void Instance::readPriorityTableR(const std::string &filepath) {
+    priorityTableR.layout(networkInfo);
     for (int i = 1; i <= nbClients; ++i) {
-        std::vector<std::vector<double>> curPriorityTable;
-        std::ifstream inFile(filepath + "BCRFR_" + std::to_string(i) + ".txt");
-        std::string line;
-        while (std::getline(inFile, line)) {
-            std::istringstream iss(line);
-            std::vector<double> row;
+        readStationTable(filepath + "BCRFR_" + std::to_string(i) + ".txt", i, priorityTableR);
+    }
+}
+
+// reads the dissat, BCRF and BCRFR files of every station on a pool of nbThreads threads, each file is parsed into
+// its own preallocated slot of the table arenas so the threads never write to the same memory
+void Instance::readStationTablesParallel(const std::string &filepath, int nbThreads) {
+    dissatTable.layout(networkInfo);
+    priorityTable.layout(networkInfo);
+    priorityTableR.layout(networkInfo);
+    const std::string prefixes[3] = {"dissat_table_", "BCRF_", "BCRFR_"};
+    StationTable *tables[3] = {&dissatTable, &priorityTable, &priorityTableR};
+    ThreadHelper::parallelFor(3 * nbClients, nbThreads, [&](int task) {
+        int station = task / 3 + 1;
+        readStationTable(filepath + prefixes[task % 3] + std::to_string(station) + ".txt", station, *tables[task % 3]);
+    });
+}
+
+// reads the (C + 1) x (C + 1) text table of one station into its triangular slot, the padding cells p + b > C of
+// each row are skipped
+void Instance::readStationTable(const std::string &filename, int station, StationTable &table) {
+    // one reader per thread, so the file buffer is reused across all the tables a thread reads
+    thread_local NumberReader reader;
+    reader.open(filename);
+    parseStationTable(reader, station, table);
+}
+
+void Instance::parseStationTable(NumberReader &reader, int station, StationTable &table) {
+    int capacity = networkInfo[station].capacity;
+    for (int p = 0; p <= capacity; p++) {
+        double *row = table.row(station, p);
+        for (int b = 0; b <= capacity - p; b++) { reader.expectInLine(row[b]); }
+        reader.skipLine();
+    }
+}
 
-            double value;
-            while (iss >> value) { row.push_back(value); }
+Instance::Instance(std::istream &stream, const std::string &source, double proportion, bool expIsProportion) {
+    isProportion = expIsProportion;
+    proportionRatio = proportion;
+    readInstanceStream(stream, source);
+    computeBaselineDissat();
+    computeBestRepair();
+}
 
-            curPriorityTable.push_back(row);
+// reads a single-document instance (see pack_instance.sh): a "BRPWR-STREAM <version> <nbClients>" line, sections
+// "<name> [station] <length>" each followed by exactly length bytes of the text file they stand for, and an "end"
+// line. Each section is parsed as soon as it is read, so the document can be piped; station_info must come before
+// the tables, which are sized from the capacities
+void Instance::readInstanceStream(std::istream &stream, const std::string &source) {
+    std::string line;
+    std::getline(stream, line);
+    std::istringstream header(line);
+    std::string magic;
+    int version = 0;
+    if (!(header >> magic >> version >> nbClients) || magic != "BRPWR-STREAM" || version != 1 || nbClients <= 0) {
+        throw std::runtime_error("Not an instance stream (version 1): " + source);
+    }
+
+    const std::string tableNames[3] = {"dissat_table", "BCRF", "BCRFR"};
+    StationTable *tables[3] = {&dissatTable, &priorityTable, &priorityTableR};
+    std::vector<char> tableRead(3 * (nbClients + 1), 0);
+    bool matrixRead = false;
+    bool ended = false;
+    NumberReader reader;
+    while (!ended && std::getline(stream, line)) {
+        std::istringstream section(line);
+        std::string name;
+        section >> name;
+        if (name == "end") {
+            ended = true;
+            continue;
+        }
+        int table = static_cast<int>(std::find(tableNames, tableNames + 3, name) - tableNames);
+        int station = 0;
+        std::size_t length;
+        if ((table < 3 && !(section >> station)) || !(section >> length)) {
+            throw std::runtime_error("Malformed section header '" + line + "' in " + source);
         }
-        priorityTableR.push_back(curPriorityTable);
+        reader.read(stream, length, source + " (" + line + ")");
+
+        if (name == "station_info") {
+            if (!networkInfo.empty()) { throw std::runtime_error("Duplicate station_info section in " + source); }
+            parseStationInfo(reader, isProportion);
+            if (static_cast<int>(networkInfo.size()) != nbClients + 1) {
+                throw std::runtime_error("station_info of " + source + " does not hold " + std::to_string(nbClients)
+                                         + " stations");
+            }
+            for (StationTable *stationTable : tables) { stationTable->layout(networkInfo); }
+        } else if (name == "time_matrix") {
+            parseMatrix(reader);
+            matrixRead = true;
+        } else if (table < 3) {
+            if (networkInfo.empty()) {
+                throw std::runtime_error("station_info must come before the tables in " + source);
+            }
+            if (station < 1 || station > nbClients || tableRead[3 * station + table]) {
+                throw std::runtime_error("Unexpected section '" + line + "' in " + source);
+            }
+            parseStationTable(reader, station, *tables[table]);
+            tableRead[3 * station + table] = 1;
+        } else {
+            throw std::runtime_error("Unknown section '" + line + "' in " + source);
+        }
+    }
+
+    if (!ended || !matrixRead || networkInfo.empty()
+        || std::count(tableRead.begin(), tableRead.end(), 1) != 3 * nbClients) {
+        throw std::runtime_error("Incomplete instance stream: " + source);
     }
 }
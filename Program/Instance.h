@@ -3,28 +3,69 @@
 //
 
 #pragma once
+#include "Matrix.h"
+#include "RepairTable.h"
 #include "Station.h"
+#include "StationTable.h"
 #include <climits>
+#include <istream>
+#include <memory>
 #include <string>
 #include <vector>
 
+class NumberReader;
+
 class Instance {
 public:
-    std::vector<std::vector<double>> dist_mtx;
-    std::vector<std::vector<std::vector<double>>> dissatTable;
-    std::vector<std::vector<std::vector<double>>> priorityTable;
-    std::vector<std::vector<std::vector<double>>> priorityTableR;
+    Matrix<double> dist_mtx;     // truck travel times, dist_mtx(from, to), the depot is 0
+    Matrix<double> rpm_dist_mtx; // repairman travel times, dist_mtx scaled by repairmanSpeedFactor
+    double repairmanSpeedFactor = 1.68; // the repairmen ride bikes, their trips take this many times longer
+    StationTable dissatTable;    // dissatTable(station, usable, broken)
+    StationTable priorityTable;  // BCRF of the trucks, priorityTable(station, usable, broken)
+    StationTable priorityTableR; // BCRFR of the repairmen, priorityTableR(station, usable, broken)
+    RepairTable bestRepair;      // bestRepair(station, usable, broken, cap), derived from dissatTable
+    // nearestSuccessors(i, r) is the r-th closest station to go to from node i (the depot included),
+    // nearestPredecessors(i, r) the r-th closest one to come from, as the travel times are asymmetric. The repairmen
+    // times are the same matrix scaled, so the lists hold for them too. Empty unless computeNeighbors was called
+    Matrix<int> nearestSuccessors;
+    Matrix<int> nearestPredecessors;
+    std::vector<double> initialDissat; // dissatisfaction of each station before any repositioning
+    double baselineDissat = 0.;         // sum of initialDissat, the dissatisfaction of a solution visiting nothing
     std::vector<double> service_time;
     std::vector<double> demands;
     std::vector<Station> networkInfo;
     int nbClients; // Number of clients (excluding the depot)
     double proportionRatio;
     bool isProportion = false;
+    std::shared_ptr<const void> image; // compiled image or shared segment the tables point into, if any
+    std::string pathToInstance; // folder holding the text files (and the compiled image) of the instance
 
-    Instance(int nbClient, const std::string &instNo, double proportionRatio, bool proportion);
+    // Loads the instance from its compiled image when one is present and valid (see BinaryHelper), otherwise from
+    // the text files, parsing the station tables on nbLoadThreads threads (0: one per hardware thread). With
+    // useShared the tables are read from the shared-memory segment of the instance, published by the first process
+    // loading it (see ShmHelper).
+    Instance(int nbClient, const std::string &instNo, double proportionRatio, bool proportion, bool useBinary = true,
+        int nbLoadThreads = 0, bool useShared = false);
+    // Loads a single-document instance stream (see readInstanceStream) from stdin, a pipe or a file; source names
+    // the stream in the errors
+    Instance(std::istream &stream, const std::string &source, double proportionRatio, bool proportion);
+    std::string binaryPath() const;
+    void computeRepairmanTimes();
+    void computeBaselineDissat();
+    void computeBestRepair();
+    // Computes the lists of the k closest stations of every node, 0 to use every station as a candidate
+    void computeNeighbors(int k);
+    int nbNeighbors() const { return nearestSuccessors.nbCols(); }
+    void addStation(int capacity, int usableBike, int targetUsable, int brokenBike);
     void readMatrixFromFile(const std::string &filepath);
     void readStationInfoFromFile(const std::string &filepath, bool proportion);
     void readDissatisTable(const std::string &filepath);
     void readPriorityTable(const std::string &filepath);
     void readPriorityTableR(const std::string &filepath);
+    void readStationTablesParallel(const std::string &filepath, int nbThreads);
+    void readStationTable(const std::string &filename, int station, StationTable &table);
+    void readInstanceStream(std::istream &stream, const std::string &source);
+    void parseMatrix(NumberReader &reader);
+    void parseStationInfo(NumberReader &reader, bool proportion);
+    void parseStationTable(NumberReader &reader, int station, StationTable &table);
 };
@@ -1,55 +1,62 @@
 #include "LocalSearch.h"
-#include <functional>
+#include <algorithm>
 #include <unordered_set>
 
 // Constructor
 LocalSearch::LocalSearch(Params &params, Instance &instance)
-    : params(params), instance(instance) {}
+    : params(params), instance(instance) {
+  for (int move = 1; move <= 9; move++) {
+    std::string name = "move_" + std::to_string(move);
+    if (params.ap.fleetScopedMoves) {
+      moveStats.push_back({name + "_trk", move, MoveScope::Trucks});
+      moveStats.push_back({name + "_rpm", move, MoveScope::Repairmen});
+    } else {
+      moveStats.push_back({name, move, MoveScope::Both});
+    }
+  }
+}
 
 int LocalSearch::getRand(int maxNum) {
   std::uniform_int_distribution<int> dist(0, maxNum - 1);
   return dist(params.ran);
 }
 
+Individual LocalSearch::applyMove(MoveStats &op, Individual &indiv) {
+  using Move = Individual (LocalSearch::*)(Individual &, MoveScope);
+  static constexpr Move moves[] = {
+      &LocalSearch::move_1, &LocalSearch::move_2, &LocalSearch::move_3,
+      &LocalSearch::move_4, &LocalSearch::move_5, &LocalSearch::move_6,
+      &LocalSearch::move_7, &LocalSearch::move_8, &LocalSearch::move_9};
+  op.nbMoves++;
+  return (this->*moves[op.move - 1])(indiv, op.scope);
+}
+
 // Run the local search
 void LocalSearch::run(Individual &indiv) {
-  using EduOp = std::function<Individual(Individual &)>;
-  std::vector<std::pair<EduOp, std::string>> move_list = {
-      std::make_pair([this](Individual &indiv) { return this->move_1(indiv); },
-                     "move_1"),
-      std::make_pair([this](Individual &indiv) { return this->move_2(indiv); },
-                     "move_2"),
-      std::make_pair([this](Individual &indiv) { return this->move_3(indiv); },
-                     "move_3"),
-      std::make_pair([this](Individual &indiv) { return this->move_4(indiv); },
-                     "move_4"),
-      std::make_pair([this](Individual &indiv) { return this->move_5(indiv); },
-                     "move_5"),
-      std::make_pair([this](Individual &indiv) { return this->move_6(indiv); },
-                     "move_6"),
-      std::make_pair([this](Individual &indiv) { return this->move_7(indiv); },
-                     "move_7"),
-      std::make_pair([this](Individual &indiv) { return this->move_8(indiv); },
-                     "move_8"),
-      std::make_pair([this](Individual &indiv) { return this->move_9(indiv); },
-                     "move_9")};
+  // the operators not tried yet
+  std::vector<std::size_t> move_list(moveStats.size());
+  for (std::size_t i = 0; i < move_list.size(); i++) {
+    move_list[i] = i;
+  }
   while (!move_list.empty()) {
     int index = getRand(move_list.size()); // choose a random index
-    EduOp edu_op = move_list[index].first; // get the function at that index
+    MoveStats &edu_op = moveStats[move_list[index]]; // get the operator at that index
     auto fit_v = indiv.eval.objVal;
-    Individual educated_ind =
-        executeAndDisplayMove(edu_op, indiv, move_list[index].second);
-    move_list.erase(move_list.begin() + index); // remove the chosen function
+    Individual educated_ind = applyMove(edu_op, indiv);
+    move_list.erase(move_list.begin() + index); // remove the chosen operator
     if (educated_ind.eval.objVal < fit_v) {
+      edu_op.nbImprovements++;
       int consecutive_imp = 0;
       int consecutive = 0;
       indiv = educated_ind;
       fit_v = indiv.eval.objVal;
       while (consecutive_imp < params.itEDU && consecutive < 1000) {
-        executeAndDisplayMove(edu_op, educated_ind, move_list[index].second);
+        // keep walking from the last neighbour, improving or not
+        educated_ind = applyMove(edu_op, educated_ind);
         if (educated_ind.eval.objVal >= fit_v) {
           consecutive_imp += 1;
         } else {
+          edu_op.nbImprovements++;
           consecutive_imp = 0;
           indiv = educated_ind;
           fit_v = indiv.eval.objVal;
@@ -61,6 +68,13 @@ void LocalSearch::run(Individual &indiv) {
   }
 }
 
+void LocalSearch::printMoveStats(std::ostream &out) const {
+  for (const MoveStats &op : moveStats) {
+    out << op.name << ": " << op.nbImprovements << " improvements in "
+        << op.nbMoves << " moves" << std::endl;
+  }
+}
+
 // single node swap: randomly select one station in each route other than the
 // first and last station, swap them
 void LocalSearch::swapTwoRandomElements(std::vector<std::vector<int>> &routes) {
@@ -79,16 +93,20 @@ void LocalSearch::swapTwoRandomElements(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_1(Individual &indiv) {
+Individual LocalSearch::move_1(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
 
   // Swap two random elements in chromRPM and chromTRK
-  swapTwoRandomElements(chromRPM);
-  swapTwoRandomElements(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    swapTwoRandomElements(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    swapTwoRandomElements(chromTRK);
+  }
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, this->instance, chromRPM, chromTRK};
+  return {params, this->instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // subtour swap: pick up two subtours in each route, swap them. Before choosing
@@ -150,15 +168,19 @@ void LocalSearch::swapTwoSubtours(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_2(Individual &indiv) {
+Individual LocalSearch::move_2(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
   // Swap two subtours in chromRPM and chromTRK
-  swapTwoSubtours(chromRPM);
-  swapTwoSubtours(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    swapTwoSubtours(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    swapTwoSubtours(chromTRK);
+  }
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // single node relocation: choose one station in each route other than the first
@@ -185,15 +207,19 @@ void LocalSearch::relocateOneNode(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_3(Individual &indiv) {
+Individual LocalSearch::move_3(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
   // Relocate one node in chromRPM and chromTRK
-  relocateOneNode(chromRPM);
-  relocateOneNode(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    relocateOneNode(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    relocateOneNode(chromTRK);
+  }
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // subtour relocation: choose one subtour in each route, relocate it to another
@@ -231,15 +257,19 @@ void LocalSearch::relocateOneSubtour(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_4(Individual &indiv) {
+Individual LocalSearch::move_4(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
   // Relocate one subtour in chromRPM and chromTRK
-  relocateOneSubtour(chromRPM);
-  relocateOneSubtour(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    relocateOneSubtour(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    relocateOneSubtour(chromTRK);
+  }
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // 2-opt: choose one subtour in each route, reverse it
@@ -262,21 +292,27 @@ void LocalSearch::reverseOneSubtour(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_5(Individual &indiv) {
+Individual LocalSearch::move_5(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
 
   // Reverse one subtour in chromRPM and chromTRK
-  reverseOneSubtour(chromRPM);
-  reverseOneSubtour(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    reverseOneSubtour(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    reverseOneSubtour(chromTRK);
+  }
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // single node insertion: choose one station from (1 to params.nbClient
 // (including)) that is not in the route, insert it to a position other than the
-// first and the end if every node is already in the route
+// first and the end if every node is already in the route. With the neighbor
+// lists the station is drawn among the closest ones to the stop before the
+// position
 void LocalSearch::insertOneNode(std::vector<std::vector<int>> &routes,
                                 bool isRPM) {
   for (auto &route : routes) {
@@ -293,6 +329,21 @@ void LocalSearch::insertOneNode(std::vector<std::vector<int>> &routes,
     if (route.size() > 3) {
       int index1 =
           getRand(route.size() - 2) + 1; // Adjusted to exclude depot nodes
+      if (instance.nbNeighbors() > 0) {
+        // granular insertion: the station is one of the closest to the stop
+        // it follows, the move is void when it cannot be inserted
+        int node = instance.nearestSuccessors(
+            route[index1 - 1], getRand(instance.nbNeighbors()));
+        bool insertable =
+            isRPM ? instance.networkInfo[node].brokenBike != 0 &&
+                        std::find(route.begin(), route.end(), node) ==
+                            route.end()
+                  : instance.networkInfo[node].usableBike !=
+                        instance.networkInfo[node].targetUsable;
+        if (insertable)
+          route.insert(route.begin() + index1, node);
+        continue;
+      }
       int node = getRand(params.nbClients) + 1;
       if (isRPM) {
         while (std::find(route.begin(), route.end(), node) != route.end()) {
@@ -310,17 +361,21 @@ void LocalSearch::insertOneNode(std::vector<std::vector<int>> &routes,
   }
 }
 
-Individual LocalSearch::move_6(Individual &indiv) {
+Individual LocalSearch::move_6(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
 
   // Insert one node in chromRPM and chromTRK
-  insertOneNode(chromRPM, true);
-  insertOneNode(chromTRK, false);
+  if (scope != MoveScope::Trucks) {
+    insertOneNode(chromRPM, true);
+  }
+  if (scope != MoveScope::Repairmen) {
+    insertOneNode(chromTRK, false);
+  }
 
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // multiple node insertion: basically multiple time single node insertion, the
@@ -339,16 +394,20 @@ void LocalSearch::insertMultipleNodes(std::vector<std::vector<int>> &routes,
   }
 }
 
-Individual LocalSearch::move_7(Individual &indiv) {
+Individual LocalSearch::move_7(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
   // Insert multiple nodes in chromRPM and chromTRK
-  insertMultipleNodes(chromRPM, true);
-  insertMultipleNodes(chromTRK, false);
+  if (scope != MoveScope::Trucks) {
+    insertMultipleNodes(chromRPM, true);
+  }
+  if (scope != MoveScope::Repairmen) {
+    insertMultipleNodes(chromTRK, false);
+  }
 
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // single node deletion: choose one station from the route other than the first
@@ -362,17 +421,21 @@ void LocalSearch::deleteOneNode(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_8(Individual &indiv) {
+Individual LocalSearch::move_8(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
 
   // Delete one node in chromRPM and chromTRK
-  deleteOneNode(chromRPM);
-  deleteOneNode(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    deleteOneNode(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    deleteOneNode(chromTRK);
+  }
 
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 // multiple node deletion: basically multiple time single node deletion, the
@@ -390,16 +453,20 @@ void LocalSearch::deleteMultipleNodes(std::vector<std::vector<int>> &routes) {
   }
 }
 
-Individual LocalSearch::move_9(Individual &indiv) {
+Individual LocalSearch::move_9(Individual &indiv, MoveScope scope) {
   // Extract chromRPM and chromTRK from indiv
   std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
   std::vector<std::vector<int>> chromTRK =
       indiv.chromTRK; // Delete multiple nodes in chromRPM and chromTRK
-  deleteMultipleNodes(chromRPM);
-  deleteMultipleNodes(chromTRK);
+  if (scope != MoveScope::Trucks) {
+    deleteMultipleNodes(chromRPM);
+  }
+  if (scope != MoveScope::Repairmen) {
+    deleteMultipleNodes(chromTRK);
+  }
 
   // Construct a new Individual with the modified chromRPM and chromTRK
-  return {params, instance, chromRPM, chromTRK};
+  return {params, instance, chromRPM, chromTRK, indiv.trace.get()};
 }
 
 void LocalSearch::display2DVector(const std::vector<std::vector<int>> &routes) {
@@ -410,16 +477,3 @@ void LocalSearch::display2DVector(const std::vector<std::vector<int>> &routes) {
     std::cout << std::endl;
   }
 }
-
-Individual LocalSearch::executeAndDisplayMove(
-    const std::function<Individual(Individual &)> &moveFunc, Individual &indiv,
-    const std::string &moveId) {
-  // Extract chromRPM and chromTRK from indiv
-  std::vector<std::vector<int>> chromRPM = indiv.chromRPM;
-  std::vector<std::vector<int>> chromTRK = indiv.chromTRK;
-
-  // Perform the move operation
-  Individual newIndiv = moveFunc(indiv);
-
-  return newIndiv;
-}
@@ -1,16 +1,36 @@
 #pragma once
 
 #include "Individual.h"
-#include <functional>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Fleet whose routes a move perturbs
+enum class MoveScope { Both, Trucks, Repairmen };
+
+// One local search operator (a move and the fleet it perturbs) and how it
+// fared: every evaluated move, and the ones improving the individual
+struct MoveStats {
+  std::string name;
+  int move;        // 1 to 9, move_1 ... move_9
+  MoveScope scope;
+  std::uint64_t nbMoves = 0;
+  std::uint64_t nbImprovements = 0;
+};
 
 // Main local search structure
 class LocalSearch {
 public:
   Params &params;     // Problem parameters
   Instance &instance; // Problem instance
+  // The operators of the local search: each move on both fleets, or each move
+  // on the trucks only and on the repairmen only (params.ap.fleetScopedMoves)
+  std::vector<MoveStats> moveStats;
   // Constructor
   LocalSearch(Params &params, Instance &instance);
   void run(Individual &indiv); // Run the local search
+  Individual applyMove(MoveStats &op, Individual &indiv);
+  void printMoveStats(std::ostream &out) const;
   void swapTwoRandomElements(std::vector<std::vector<int>> &routes);
 
   void swapTwoSubtours(std::vector<std::vector<int>> &routes);
@@ -29,28 +49,25 @@ public:
 
   void deleteMultipleNodes(std::vector<std::vector<int>> &routes);
 
-  Individual move_1(Individual &indiv);
+  Individual move_1(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_2(Individual &indiv);
+  Individual move_2(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_3(Individual &indiv);
+  Individual move_3(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_4(Individual &indiv);
+  Individual move_4(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_5(Individual &indiv);
+  Individual move_5(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_6(Individual &indiv);
+  Individual move_6(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_7(Individual &indiv);
+  Individual move_7(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_8(Individual &indiv);
+  Individual move_8(Individual &indiv, MoveScope scope = MoveScope::Both);
 
-  Individual move_9(Individual &indiv);
+  Individual move_9(Individual &indiv, MoveScope scope = MoveScope::Both);
 
   int getRand(int maxNum);
 
   void display2DVector(const std::vector<std::vector<int>> &routes);
-  Individual
-  executeAndDisplayMove(const std::function<Individual(Individual &)> &moveFunc,
-                        Individual &indiv, const std::string &moveId);
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Allocator handing out storage aligned on Align bytes
+template <typename T, std::size_t Align> struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align> &) {}
+
+    T *allocate(std::size_t n) { return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Align))); }
+    void deallocate(T *p, std::size_t) { ::operator delete(p, std::align_val_t(Align)); }
+    template <typename U> bool operator==(const AlignedAllocator<U, Align> &) const { return true; }
+};
+
+// Dense row-major matrix in one contiguous block whose first cell is aligned on a cache line, accessed as m(i, j).
+// Used for the travel time matrices, so a route time sum walks a single block instead of one heap row per station.
+template <typename T> class Matrix {
+public:
+    Matrix() = default;
+    Matrix(int nbRows, int nbCols, T value = T()) { assign(nbRows, nbCols, value); }
+
+    void assign(int nbRows, int nbCols, T value = T()) {
+        rows = nbRows;
+        cols = nbCols;
+        cells.assign(static_cast<std::size_t>(nbRows) * nbCols, value);
+    }
+
+    T &operator()(int i, int j) { return cells[static_cast<std::size_t>(i) * cols + j]; }
+    const T &operator()(int i, int j) const { return cells[static_cast<std::size_t>(i) * cols + j]; }
+
+    T *row(int i) { return cells.data() + static_cast<std::size_t>(i) * cols; }
+    const T *row(int i) const { return cells.data() + static_cast<std::size_t>(i) * cols; }
+    T *data() { return cells.data(); }
+    const T *data() const { return cells.data(); }
+
+    int nbRows() const { return rows; }
+    int nbCols() const { return cols; }
+    std::size_t size() const { return cells.size(); }
+
+    bool operator==(const Matrix &other) const {
+        return rows == other.rows && cols == other.cols && cells == other.cells;
+    }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::vector<T, AlignedAllocator<T, 64>> cells;
+};
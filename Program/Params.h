@@ -1,5 +1,7 @@
 #pragma once
 
+#include "EvaluationCache.h"
+#include "RepairmanCache.h"
 #include <chrono>
 #include <climits>
 #include <cmath>
@@ -17,6 +19,14 @@ struct AlgorithmParameters {
   /* ADAPTIVE PENALTY COEFFICIENTS */
   double penaltyCapacity = 100.; // Penalty for one unit of capacity excess
                                  // (adapted through the search)
+  bool fleetScopedMoves = false; // Local search moves perturb the trucks or
+                                 // the repairmen, not both at once
+  bool leanIndividuals = false;  // The population keeps the individuals
+                                 // without their schemes
+  bool singlePassAssignment = false; // The schemes of a route are assigned
+                                     // once and patched, never re-assigned
+  bool optimalRepairTime = false; // The repair time of a repairman route is
+                                  // allocated by a knapsack, not greedily
 };
 
 class Params {
@@ -40,6 +50,11 @@ public:
              // a solution is repeated
   AlgorithmParameters ap;
 
+  /* CACHE OF THE REPAIRMEN ASSIGNMENTS, shared by every build */
+  RepairmanCache repairmanCache;
+  /* CACHE OF THE INDIVIDUALS BUILT FROM GIVEN ROUTES */
+  EvaluationCache evaluationCache;
+
   // Initialization from a given data set
   Params(int nbClients, int nbVeh, int nbRepairmen, int vehicleCapacity,
          int repairTime, int loadingTime, int mu, int lambda,
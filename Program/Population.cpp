@@ -1,8 +1,18 @@
 #include "Population.h"
 #include "LocalSearch.h"
+#include <algorithm>
 #include <random>
 #include <unordered_set>
 
+namespace {
+    // copy of an individual kept in the population, without its schemes in
+    // the lean mode, as selection and survival only read the chromosomes and
+    // the evaluation
+    Individual keptCopy(const Individual &indiv, const Params &params) {
+        return params.ap.leanIndividuals ? indiv.withoutSchemes() : indiv;
+    }
+} // namespace
+
 Population::Population(Instance &instance) : instance(instance) {
 }
 
@@ -199,11 +209,11 @@ void Population::diversification(Params &params) {
         // add the solution to the corresponding subpopulation if it is not in the
         // subpopulation
         if (randomIndiv.eval.isFeasible && std::find (feasibleSolution.begin(), feasibleSolution.end(), randomIndiv) == feasibleSolution.end()) {
-            newFeasibleSolutionCandidate.push_back(randomIndiv);
+            newFeasibleSolutionCandidate.push_back(keptCopy(randomIndiv, params));
             ++totalSize;
         }
         if (!randomIndiv.eval.isFeasible && std::find (infeasibleSolution.begin(), infeasibleSolution.end(), randomIndiv) == infeasibleSolution.end()) {
-            newInfeasibleSolutionCandidate.push_back(randomIndiv);
+            newInfeasibleSolutionCandidate.push_back(keptCopy(randomIndiv, params));
             ++totalSize;
         }
     }
@@ -259,8 +269,8 @@ void Population::addIndividualToSubpopulation(Individual &indiv, Params &params)
     auto addIndividual
         = [&](std::vector<Individual> &solution, std::vector<Individual> &latestLoad, Individual &indiv) {
               if (std::find(solution.begin(), solution.end(), indiv) == solution.end()) {
-                  solution.push_back(indiv);
-                  latestLoad.push_back(indiv);
+                  solution.push_back(keptCopy(indiv, params));
+                  latestLoad.push_back(solution.back());
                   return true;
               }
               return false;
@@ -0,0 +1,37 @@
+#include "RepairTable.h"
+
+void RepairTable::build(const std::vector<Station> &networkInfo, const StationTable &dissatTable) {
+    rowSlot.assign(networkInfo.size(), 0);
+    rowBase.clear();
+    std::size_t nbCounts = 0;
+    for (std::size_t s = 1; s < networkInfo.size(); s++) {
+        int capacity = networkInfo[s].capacity;
+        rowSlot[s] = rowBase.size();
+        // row p holds the blocks b = 0..C - p, block b holds the counts of the caps 0..b
+        for (int p = 0; p <= capacity; p++) {
+            rowBase.push_back(nbCounts);
+            std::size_t rowLength = capacity - p + 1;
+            nbCounts += rowLength * (rowLength + 1) / 2;
+        }
+    }
+    counts.assign(nbCounts, 0);
+
+    for (int s = 1; s < static_cast<int>(networkInfo.size()); s++) {
+        int capacity = networkInfo[s].capacity;
+        for (int p = 0; p <= capacity; p++) {
+            for (int b = 0; b <= capacity - p; b++) {
+                std::uint16_t *block = counts.data() + rowBase[rowSlot[s] + p] + b * (b + 1) / 2;
+                double minDissatisfaction = dissatTable(s, p, b);
+                int best = 0;
+                for (int i = 1; i <= b; i++) {
+                    double dissatisfaction = dissatTable(s, p + i, b - i);
+                    if (dissatisfaction < minDissatisfaction) {
+                        minDissatisfaction = dissatisfaction;
+                        best = i;
+                    }
+                    block[i] = static_cast<std::uint16_t>(best);
+                }
+            }
+        }
+    }
+}
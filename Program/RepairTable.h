@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Station.h"
+#include "StationTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Best number of bikes to repair at a station, for every inventory (usable, broken) and every repair cap. Repairing
+// i bikes moves the station to (usable + i, broken - i), along a diagonal of its dissatisfaction table, and the best
+// count is the first i in [0, cap] of least dissatisfaction, 0 when no repair lowers it. The counts of an inventory
+// are its prefix argmin along the diagonal, one per cap 0..broken, computed once per instance so that the choice of
+// the repairmen is a lookup instead of a scan of the diagonal. A station of capacity C holds about C^3 / 6 counts.
+class RepairTable {
+public:
+    // Computes the counts of every station from its dissatisfaction table
+    void build(const std::vector<Station> &networkInfo, const StationTable &dissatTable);
+
+    // Best repair count at a station holding usable and broken bikes, usable + broken <= its capacity, when at most
+    // maxRepair bikes can be repaired, 0 <= maxRepair <= broken
+    int operator()(int station, int usable, int broken, int maxRepair) const {
+        return counts[rowBase[rowSlot[station] + usable] + broken * (broken + 1) / 2 + maxRepair];
+    }
+
+private:
+    std::vector<std::size_t> rowSlot; // first row of each station in rowBase
+    std::vector<std::size_t> rowBase; // first count of each (station, usable) row, the broken counts follow
+    std::vector<std::uint16_t> counts;
+};
@@ -0,0 +1,51 @@
+#include "RepairmanCache.h"
+#include "helpers/HashHelper.h"
+
+namespace {
+    bool sameRoutes(const RepairmenAssignment &assignment, const std::vector<std::vector<int>> &routes) {
+        if (assignment.size() != routes.size()) { return false; }
+        for (std::size_t i = 0; i < routes.size(); i++) {
+            if (assignment[i]->route != routes[i]) { return false; }
+        }
+        return true;
+    }
+} // namespace
+
+const RepairmenAssignment *RepairmanCache::find(const std::vector<std::vector<int>> &routes) {
+    if (capacity == 0) { return nullptr; }
+    auto it = index.find(HashHelper::hashRoutes(routes));
+    // a hash collision counts as a miss
+    if (it == index.end() || !sameRoutes(it->second->assignment, routes)) {
+        nbMisses++;
+        return nullptr;
+    }
+    nbHits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return &entries.front().assignment;
+}
+
+void RepairmanCache::insert(const RepairmenAssignment &assignment) {
+    if (capacity == 0) { return; }
+    std::uint64_t key = HashHelper::fnvOffset;
+    for (const auto &routeAssignment : assignment) { key = HashHelper::mixRoute(key, routeAssignment->route); }
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->assignment = assignment;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    if (entries.size() >= capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+    entries.push_front({key, assignment});
+    index[key] = entries.begin();
+}
+
+void RepairmanCache::setCapacity(std::size_t newCapacity) {
+    capacity = newCapacity;
+    while (entries.size() > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
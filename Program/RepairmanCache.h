@@ -0,0 +1,39 @@
+#pragma once
+
+#include "BuildTrace.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+// Bounded LRU cache of the greedy repairman assignments of Individual::buildIndividual. The repairmen are assigned
+// first, from the initial inventories, so their assignment only depends on the repairman routes handed to it. The
+// amendments run after the trucks and are not cached.
+class RepairmanCache {
+public:
+    explicit RepairmanCache(std::size_t capacity = 1024) : capacity(capacity) {}
+
+    // Assignment of the routes if it is cached (a hit), nullptr otherwise (a miss); the pointer is valid until the
+    // next insert
+    const RepairmenAssignment *find(const std::vector<std::vector<int>> &routes);
+    // Caches an assignment under the routes it was given, evicting the least recently used one when full
+    void insert(const RepairmenAssignment &assignment);
+    // Drops the entries beyond the new capacity, 0 disables the cache
+    void setCapacity(std::size_t newCapacity);
+
+    std::size_t size() const { return entries.size(); }
+    std::uint64_t hits() const { return nbHits; }
+    std::uint64_t misses() const { return nbMisses; }
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        RepairmenAssignment assignment;
+    };
+
+    std::size_t capacity;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    std::uint64_t nbHits = 0;
+    std::uint64_t nbMisses = 0;
+};
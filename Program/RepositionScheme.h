@@ -4,31 +4,45 @@
 
 #pragma once
 
-struct RepositionSchemeBase {
-    int station{};           // the station ID
-    double arrivingTime = 0; // the time the entity arrives at the station
+// The schemes are plain values stored contiguously, one vector per route: copying an Individual copies its schemes.
 
-    virtual ~RepositionSchemeBase() = default; // virtual destructor for proper cleanup
-
-    // Possibly other common methods, marked as virtual if they should be
-    // overridden
-};
-
-struct RepositionSchemeTRK : public RepositionSchemeBase {
+struct RepositionSchemeTRK {
+    int station{};              // the station ID
+    double arrivingTime = 0;    // the time the truck arrives at the station
     int loadingQuantityU = 0;   // # of loaded usable bikes
     int loadingQuantityB = 0;   // # of loaded broken bikes
     int unloadingQuantityU = 0; // # of unloaded usable bikes
     int unloadingQuantityB = 0; // # of unloaded broken bikes
     int truckUQ = 0;            // truck usable bikes quantity when it leaves the station
     int truckBQ = 0;            // truck broken bikes quantity when it leaves the station
-
-    // Additional truck-specific methods
 };
 
-struct RepositionSchemeRPM : public RepositionSchemeBase {
+struct RepositionSchemeRPM {
+    int station{};             // the station ID
+    double arrivingTime = 0;   // the time the repairman arrives at the station
     int repairingQuantity = 0; // # of bikes repaired at this station
+};
+
+// One station visit in the merged timeline of all the trucks and repairmen, tagged with the kind of vehicle. It
+// carries the change of the station inventory: the unloads minus the loads of a truck, or the bikes a repairman
+// turns from broken to usable.
+struct RepositionEvent {
+    enum class Kind : unsigned char { truck, repairman };
 
-    // Additional repairman-specific methods
+    double arrivingTime = 0;
+    int station = 0;
+    Kind kind = Kind::truck;
+    int usableChange = 0;
+    int brokenChange = 0;
+
+    RepositionEvent() = default;
+    explicit RepositionEvent(const RepositionSchemeTRK &scheme) :
+        arrivingTime(scheme.arrivingTime), station(scheme.station), kind(Kind::truck),
+        usableChange(scheme.unloadingQuantityU - scheme.loadingQuantityU),
+        brokenChange(scheme.unloadingQuantityB - scheme.loadingQuantityB) {}
+    explicit RepositionEvent(const RepositionSchemeRPM &scheme) :
+        arrivingTime(scheme.arrivingTime), station(scheme.station), kind(Kind::repairman),
+        usableChange(scheme.repairingQuantity), brokenChange(-scheme.repairingQuantity) {}
 };
 
 struct ReachableListCandidateTRK {
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Station.h"
+#include <cstddef>
+#include <vector>
+
+// A (usable, broken) table of every station (dissatisfaction, BCRF or BCRFR) stored in one contiguous arena.
+// Only the cells p + b <= C of a station are meaningful, so the rows are stored triangularly: row p of station s
+// holds b = 0..C_s - p and starts at slot[s].offset + p * (C_s + 1) - p * (p - 1) / 2. Stations are indexed
+// 1..nbClients, the depot has an empty slot. The cells are either owned or borrowed from a mapped binary image.
+class StationTable {
+public:
+    // Computes the station offsets from the capacities and allocates zeroed storage
+    void layout(const std::vector<Station> &networkInfo) {
+        computeSlots(networkInfo);
+        storage.assign(size(), 0.);
+        external = nullptr;
+    }
+
+    // Computes the station offsets and reads the cells from external memory laid out the same way (a mapped
+    // binary image); the memory must outlive the table
+    void adopt(const std::vector<Station> &networkInfo, const double *cells) {
+        computeSlots(networkInfo);
+        storage = {};
+        external = cells;
+    }
+
+    double operator()(int station, int usable, int broken) const {
+        return data()[slot[station].offset + rowStart(slot[station].capacity, usable) + broken];
+    }
+
+    // First cell of row p of a station (b = 0..C - p follow contiguously), used to fill the table
+    double *row(int station, int usable) {
+        return storage.data() + slot[station].offset + rowStart(slot[station].capacity, usable);
+    }
+
+    const double *data() const { return external != nullptr ? external : storage.data(); }
+    std::size_t size() const { return slot.empty() ? 0 : slot.back().offset + cellsOf(slot.back().capacity); }
+
+    static std::size_t cellsOf(int capacity) {
+        return static_cast<std::size_t>(capacity + 1) * static_cast<std::size_t>(capacity + 2) / 2;
+    }
+
+    bool operator==(const StationTable &other) const {
+        if (size() != other.size()) return false;
+        for (std::size_t i = 0; i < size(); i++) {
+            if (data()[i] != other.data()[i]) return false;
+        }
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::size_t offset;
+        int capacity;
+    };
+
+    void computeSlots(const std::vector<Station> &networkInfo) {
+        slot.assign(networkInfo.size(), {0, 0});
+        std::size_t offset = 0;
+        for (std::size_t s = 1; s < networkInfo.size(); s++) {
+            slot[s] = {offset, networkInfo[s].capacity};
+            offset += cellsOf(networkInfo[s].capacity);
+        }
+    }
+
+    // p * (C + 1) - p * (p - 1) / 2 cells precede row p
+    static std::size_t rowStart(int capacity, int usable) { return usable * (2 * capacity + 3 - usable) / 2; }
+
+    std::vector<Slot> slot;
+    std::vector<double> storage;
+    const double *external = nullptr;
+};
@@ -0,0 +1,102 @@
+// Counts the heap allocations of building an individual from given routes, the move evaluation of the local search.
+// The scratch buffers of a build come from the BuildWorkspace of the thread and its trace from the recycled traces
+// and assignments (see BuildTrace.h), so once the first passes over the individuals have grown them, rebuilding an
+// individual in place allocates nothing: the bench fails if it does. A new individual only allocates its own routes
+// and schemes, and checking and evaluating a built individual again allocates nothing. Both caches are disabled so
+// that every build is done.
+// Usage (from the build directory): ./bench_build_alloc [nbStations ...]   (default: 60 300)
+#include "Individual.h"
+#include "Instance.h"
+#include "Params.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+namespace {
+    std::atomic<unsigned long long> nbAllocations{0};
+}
+
+void *operator new(std::size_t size) {
+    nbAllocations++;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char *argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) { sizes.push_back(std::atoi(argv[i])); }
+    if (sizes.empty()) { sizes = {60, 300}; }
+    const int nbIndividuals = 20;
+    const int repeats = 20;
+    const int maxWarmUps = 100;
+    bool failed = false;
+
+    for (int nbStations : sizes) {
+        Instance instance(nbStations, "1", -0.5, false);
+        Params params(nbStations, 5, 3, 25, 300, 60, 25, 40, 100, 0.2, 5000, 18000, 10, 7200, 10);
+        params.ran.seed(1);
+        params.evaluationCache.setCapacity(0);
+        params.repairmanCache.setCapacity(0);
+        std::vector<Individual> individuals;
+        for (int i = 0; i < nbIndividuals; i++) { individuals.emplace_back(params, instance); }
+
+        std::vector<int> usable(params.nbClients + 1), broken(params.nbClients + 1);
+        std::vector<Individual> built = individuals;
+        auto rebuild = [&] {
+            for (std::size_t i = 0; i < individuals.size(); i++) {
+                built[i].chromRPM = individuals[i].chromRPM;
+                built[i].chromTRK = individuals[i].chromTRK;
+                built[i].buildIndividual(params, usable, broken, instance);
+            }
+        };
+        // the first passes grow the buffers of the workspace and the vectors of the recycled traces and assignments,
+        // which are handed to routes of other lengths, until a whole pass allocates nothing
+        int nbWarmUps = 0;
+        for (bool warm = false; !warm && nbWarmUps < maxWarmUps; nbWarmUps++) {
+            unsigned long long before = nbAllocations;
+            rebuild();
+            warm = nbAllocations == before;
+        }
+
+        unsigned long long start = nbAllocations;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) { rebuild(); }
+        auto elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        double build = static_cast<double>(nbAllocations - start) / (repeats * nbIndividuals);
+        double buildTime = std::chrono::duration<double, std::micro>(elapsed).count() / (repeats * nbIndividuals);
+
+        start = nbAllocations;
+        for (const Individual &individual : individuals) {
+            Individual constructed(params, instance, individual.chromRPM, individual.chromTRK);
+        }
+        double construction = static_cast<double>(nbAllocations - start) / nbIndividuals;
+
+        start = nbAllocations;
+        for (Individual &individual : individuals) {
+            individual.feasibilityCheckOfSolution(params, instance);
+            individual.solutionEvaluation(params);
+        }
+        double check = static_cast<double>(nbAllocations - start) / nbIndividuals;
+
+        std::cout << std::fixed << std::setprecision(1) << nbStations << " stations, warm after " << nbWarmUps
+                  << " passes: " << build << " allocations per build in place (" << buildTime << " us per build), "
+                  << construction << " per new individual, " << check << " per feasibility check and evaluation"
+                  << std::endl;
+        if (build > 0 || check > 0) {
+            std::cerr << "a warmed-up build allocates" << std::endl;
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+// Compares the two ways of ordering the visits of a solution by arrival time in feasibilityCheckOfSolution: a sort
+// of all the visits, and the k-way merge of the routes (each already in time order). The visits come from random
+// individuals, for 1 to 5 trucks and 1 to 3 repairmen. The feasibility check itself only orders the visits of the
+// stations shared by several routes, their number is reported too.
+// Usage (from the build directory): ./bench_event_merge [nbStations ...]   (default: 300 500)
+#include "Individual.h"
+#include "Instance.h"
+#include "Params.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+struct Timeline {
+    std::vector<RepositionEvent> events;
+    std::vector<std::size_t> bounds = {0};
+};
+
+Timeline timelineOf(const Individual &individual) {
+    Timeline timeline;
+    for (const auto &trkScheme : individual.repositionSchemeVectorTruck) {
+        for (std::size_t j = 1; j < trkScheme.size(); j++) { timeline.events.emplace_back(trkScheme[j]); }
+        timeline.bounds.push_back(timeline.events.size());
+    }
+    for (const auto &rpmScheme : individual.repositionSchemeVectorRepairman) {
+        for (std::size_t j = 1; j < rpmScheme.size(); j++) { timeline.events.emplace_back(rpmScheme[j]); }
+        timeline.bounds.push_back(timeline.events.size());
+    }
+    return timeline;
+}
+
+// Merges the routes of a timeline, each already in time order, into merged: neighbouring routes are merged
+// pairwise, ceil(log2(k)) passes of std::merge over the visits. The merge is stable, visits at the same time come
+// out in route order
+void mergeRoutes(const Timeline &timeline, std::vector<RepositionEvent> &merged) {
+    auto earlier = [](const RepositionEvent &a, const RepositionEvent &b) { return a.arrivingTime < b.arrivingTime; };
+    const std::vector<RepositionEvent> &events = timeline.events;
+    merged.resize(events.size());
+    if (timeline.bounds.size() <= 2) {
+        std::copy(events.begin(), events.end(), merged.begin());
+        return;
+    }
+    // the passes alternate between merged and a scratch buffer, the first one writes to the buffer that the last
+    // one must fill
+    static std::vector<RepositionEvent> scratch;
+    static std::vector<std::size_t> runBounds;
+    scratch.resize(events.size());
+    runBounds = timeline.bounds;
+    int passes = 0;
+    for (std::size_t runs = runBounds.size() - 1; runs > 1; runs = (runs + 1) / 2) { passes++; }
+    const RepositionEvent *from = events.data();
+    RepositionEvent *to = passes % 2 == 1 ? merged.data() : scratch.data();
+    RepositionEvent *next = passes % 2 == 1 ? scratch.data() : merged.data();
+    while (runBounds.size() > 2) {
+        const std::size_t nbRuns = runBounds.size() - 1;
+        std::size_t kept = 0;
+        for (std::size_t r = 0; r < nbRuns; r += 2) {
+            std::size_t first = runBounds[r], middle = runBounds[r + 1];
+            std::size_t last = r + 1 < nbRuns ? runBounds[r + 2] : middle;
+            std::merge(from + first, from + middle, from + middle, from + last, to + first, earlier);
+            runBounds[kept++] = first;
+        }
+        runBounds[kept++] = runBounds[nbRuns];
+        runBounds.resize(kept);
+        from = to;
+        std::swap(to, next);
+    }
+}
+
+// number of visits at stations visited by more than one route
+std::size_t sharedVisitsOf(const Timeline &timeline, int nbStations) {
+    std::vector<int> owner(nbStations + 1, -1), count(nbStations + 1, 0);
+    for (std::size_t r = 0; r + 1 < timeline.bounds.size(); r++) {
+        for (std::size_t k = timeline.bounds[r]; k < timeline.bounds[r + 1]; k++) {
+            int station = timeline.events[k].station;
+            owner[station] = owner[station] == -1 || owner[station] == static_cast<int>(r) ? static_cast<int>(r) : -2;
+            count[station]++;
+        }
+    }
+    std::size_t shared = 0;
+    for (int s = 1; s <= nbStations; s++) {
+        if (owner[s] == -2) { shared += count[s]; }
+    }
+    return shared;
+}
+
+// mean time of one run in microseconds, the best of 5 rounds of repeats runs to filter out the noise of a shared
+// machine
+template <typename F> double timeIt(int repeats, F &&run) {
+    double best = 0;
+    for (int round = 0; round < 5; round++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) { run(); }
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        double mean = std::chrono::duration<double, std::micro>(elapsed).count() / repeats;
+        best = round == 0 ? mean : std::min(best, mean);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) { sizes.push_back(std::atoi(argv[i])); }
+    if (sizes.empty()) { sizes = {300, 500}; }
+    const int nbIndividuals = 20;
+    const int repeats = 200;
+
+    for (int nbStations : sizes) {
+        Instance instance(nbStations, "1", -0.5, false);
+        for (auto [nbTrucks, nbRepairmen] : {std::pair{1, 1}, std::pair{2, 2}, std::pair{5, 3}}) {
+            Params params(nbStations, nbTrucks, nbRepairmen, 25, 300, 60, 25, 40, 100, 0.2, 5000, 18000, 10, 7200, 10);
+            params.ran.seed(1);
+            std::vector<Individual> individuals;
+            std::vector<Timeline> timelines;
+            std::size_t nbEvents = 0, nbShared = 0;
+            for (int i = 0; i < nbIndividuals; i++) {
+                individuals.emplace_back(params, instance);
+                timelines.push_back(timelineOf(individuals.back()));
+                nbEvents += timelines.back().events.size();
+                nbShared += sharedVisitsOf(timelines.back(), nbStations);
+            }
+
+            double sortTime = 0, mergeTime = 0;
+            std::vector<RepositionEvent> sorted, merged;
+            auto earlier = [](const RepositionEvent &a, const RepositionEvent &b) {
+                return a.arrivingTime < b.arrivingTime;
+            };
+            for (const Timeline &timeline : timelines) {
+                sortTime += timeIt(repeats, [&] {
+                    sorted = timeline.events;
+                    std::sort(sorted.begin(), sorted.end(), earlier);
+                });
+                mergeTime += timeIt(repeats, [&] { mergeRoutes(timeline, merged); });
+                for (std::size_t k = 0; k < sorted.size(); k++) {
+                    if (sorted[k].arrivingTime != merged[k].arrivingTime) {
+                        std::cerr << "merge and sort disagree" << std::endl;
+                        return 1;
+                    }
+                }
+            }
+            double checkTime = 0;
+            for (Individual &individual : individuals) {
+                checkTime += timeIt(repeats, [&] { individual.feasibilityCheckOfSolution(params, instance); });
+            }
+            std::cout << std::fixed << std::setprecision(2) << nbStations << " stations, " << nbTrucks << " trucks, "
+                      << nbRepairmen << " repairmen, " << nbEvents / nbIndividuals << " visits ("
+                      << nbShared / nbIndividuals << " at shared stations): sort " << sortTime / nbIndividuals
+                      << " us, merge " << mergeTime / nbIndividuals << " us, whole feasibility check "
+                      << checkTime / nbIndividuals << " us" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Compares the start-up cost of the instance loading paths: text files parsed on one thread, text files parsed on
+// a thread pool, and the compiled binary image. The image is compiled into the temporary directory and removed
+// afterwards, the instance folders are left as they are.
+// Usage (from the build directory): ./bench_instance_load [nbStations] [instNo] [repeats] [threads]
+// Without a station count (or with 0) every ../Instances/N_1 folder is measured, from the smallest to the largest.
+#include "Instance.h"
+#include "helpers/BinaryHelper.h"
+#include "helpers/ThreadHelper.h"
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template <typename F> double timeIt(int repeats, F &&load) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; r++) { load(); }
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+}
+
+bool sameInstance(const Instance &a, const Instance &b) {
+    return a.dist_mtx == b.dist_mtx && a.dissatTable == b.dissatTable && a.priorityTable == b.priorityTable
+           && a.priorityTableR == b.priorityTableR;
+}
+
+bool benchInstance(int nbStations, const std::string &instNo, int repeats, int threads) {
+    Instance sequential(nbStations, instNo, 0., false, false, 1);
+    Instance parallel(nbStations, instNo, 0., false, false, threads);
+    if (!sameInstance(sequential, parallel)) {
+        std::cerr << "parallel loader does not reproduce the sequential loader" << std::endl;
+        return false;
+    }
+
+    std::string imagePath = (std::filesystem::temp_directory_path()
+                             / ("brpwr_instance_" + std::to_string(nbStations) + "_" + instNo + ".bin")).string();
+    std::string compiled;
+    double compileTime =
+        timeIt(1, [&] { compiled = BinaryHelper::compileInstance(nbStations, instNo, threads, imagePath); });
+    std::cout << "compiled " << imagePath << " in " << compileTime << " s" << std::endl;
+    // the image is read into an instance loaded from the text files, as the constructor would read it
+    Instance binary(nbStations, instNo, 0., false, false, threads);
+    auto loadBinary = [&] {
+        bool read = BinaryHelper::readImage(binary, imagePath);
+        binary.computeBaselineDissat();
+        binary.computeBestRepair();
+        return read;
+    };
+    bool reproduced = !compiled.empty() && loadBinary() && sameInstance(sequential, binary);
+    double binaryTime = reproduced ? timeIt(repeats, loadBinary) : 0.;
+    binary.image.reset();
+    std::error_code error;
+    std::filesystem::remove(imagePath, error);
+    if (!reproduced) {
+        std::cerr << "binary image does not reproduce the text instance" << std::endl;
+        return false;
+    }
+
+    double textTime = timeIt(repeats, [&] { Instance instance(nbStations, instNo, 0., false, false, 1); });
+    double parallelTime = timeIt(repeats, [&] { Instance instance(nbStations, instNo, 0., false, false, threads); });
+    std::cout << std::fixed << std::setprecision(4) << nbStations << "_" << instNo << ": text " << textTime
+              << " s, text on " << threads << " threads " << parallelTime << " s, binary " << binaryTime
+              << " s (mean of " << repeats << " loads)" << std::endl;
+    return true;
+}
+
+// station counts of the ../Instances/N_1 folders, in increasing order
+std::vector<int> firstInstances() {
+    std::vector<int> sizes;
+    for (const auto &entry : std::filesystem::directory_iterator("../Instances")) {
+        std::string name = entry.path().filename().string();
+        auto underscore = name.find('_');
+        if (!entry.is_directory() || underscore == std::string::npos || name.substr(underscore + 1) != "1") continue;
+        sizes.push_back(std::atoi(name.substr(0, underscore).c_str()));
+    }
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+int main(int argc, char *argv[]) {
+    std::string instNo = argc > 2 ? argv[2] : "1";
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+    int threads = ThreadHelper::resolveThreadCount(argc > 4 ? std::atoi(argv[4]) : 0);
+    int nbStations = argc > 1 ? std::atoi(argv[1]) : 0;
+    if (nbStations > 0) { return benchInstance(nbStations, instNo, repeats, threads) ? 0 : 1; }
+
+    for (int size : firstInstances()) {
+        if (!benchInstance(size, instNo, repeats, threads)) { return 1; }
+    }
+    return 0;
+}
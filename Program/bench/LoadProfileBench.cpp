@@ -0,0 +1,149 @@
+// Checks both layouts of the LoadProfile, flat and segment tree, against a scan of the scheme, as the assignment did
+// before, on random operations that mirror unloadUsable: the residual capacity from a stop to the end of the scheme,
+// then a load added on that range. Then it times assignTruckScheme and truckSchemeAmendment with each layout on single
+// truck routes of the same lengths, returning to the depot every 20 stops and only at the end of the route, and
+// names the layout the default threshold picks for each route.
+// Usage (from the build directory): ./bench_load_profile [nbStops ...]   (default: 20 100 200 500 1000)
+#include "Instance.h"
+#include "Params.h"
+#include "helpers/LoadProfile.h"
+#include "helpers/Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// mean time of one run in microseconds, the best of 5 rounds of repeats runs to filter out the noise of a shared
+// machine
+template <typename F> double timeIt(int repeats, F &&run) {
+    double best = 0;
+    for (int round = 0; round < 5; round++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeats; r++) { run(); }
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        double mean = std::chrono::duration<double, std::micro>(elapsed).count() / repeats;
+        best = round == 0 ? mean : std::min(best, mean);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) { sizes.push_back(std::atoi(argv[i])); }
+    if (sizes.empty()) { sizes = {20, 100, 200, 500, 1000}; }
+    const int capacity = 25;
+    const int repeats = 20;
+    const int nbStations = 500;
+    Instance instance(nbStations, "1", -0.5, false);
+    // a time budget long enough for every route to be kept whole
+    Params params(nbStations, 1, 1, capacity, 300, 60, 25, 40, 100, 0.2, 5000, 1e9, 10, 7200, 10);
+    const std::size_t defaultThreshold = LoadProfile::treeThreshold;
+
+    for (int nbStops : sizes) {
+        std::mt19937 ran(1);
+        std::vector<RepositionSchemeTRK> start(nbStops);
+        for (auto &stop : start) { stop.truckUQ = static_cast<int>(ran() % 10); }
+        std::vector<std::pair<int, int>> operations(nbStops);
+        for (auto &[first, bikes] : operations) {
+            first = static_cast<int>(ran() % nbStops);
+            bikes = static_cast<int>(ran() % 3);
+        }
+
+        std::vector<RepositionSchemeTRK> scanned;
+        long long scanSum = 0, profileSum = 0;
+        double scanTime = timeIt(repeats, [&] {
+            scanned = start;
+            scanSum = 0;
+            for (auto [first, bikes] : operations) {
+                int residual = capacity - scanned[first].truckUQ - scanned[first].truckBQ;
+                for (int i = first + 1; i < nbStops; i++) {
+                    residual = std::min(residual, capacity - scanned[i].truckUQ - scanned[i].truckBQ);
+                }
+                int added = std::min(residual, bikes);
+                for (int i = first; i < nbStops; i++) { scanned[i].truckUQ += added; }
+                scanSum += residual;
+            }
+        });
+        // a threshold of 0 keeps every profile in the tree, one past the longest scheme keeps them all flat
+        const std::size_t flatThreshold = nbStops + 1, treeThreshold = 0;
+        double profileTime[2];
+        for (int layout = 0; layout < 2; layout++) {
+            LoadProfile::treeThreshold = layout == 0 ? flatThreshold : treeThreshold;
+            LoadProfile loads;
+            std::vector<RepositionSchemeTRK> profiled = start;
+            profileTime[layout] = timeIt(repeats, [&] {
+                loads.assign(capacity, start);
+                profileSum = 0;
+                for (auto [first, bikes] : operations) {
+                    int residual = loads.minResidual(first, nbStops);
+                    loads.addUsable(first, nbStops, std::min(residual, bikes));
+                    profileSum += residual;
+                }
+                loads.writeTo(profiled);
+            });
+            for (int i = 0; i < nbStops; i++) {
+                if (scanned[i].truckUQ != profiled[i].truckUQ || scanSum != profileSum) {
+                    std::cerr << "scan and profile disagree" << std::endl;
+                    return 1;
+                }
+            }
+        }
+        std::cout << std::fixed << std::setprecision(2) << nbStops << " stops: " << operations.size()
+                  << " range queries and loads, scan " << scanTime << " us, flat " << profileTime[0] << " us, tree "
+                  << profileTime[1] << " us" << std::endl;
+
+        std::vector<int> stations(nbStations);
+        std::iota(stations.begin(), stations.end(), 1);
+        std::shuffle(stations.begin(), stations.end(), ran);
+        for (int depotEvery : {20, 0}) {
+            std::vector<int> route = {0};
+            for (int i = 0; static_cast<int>(route.size()) < nbStops - 1; i++) {
+                route.push_back(stations[i % nbStations]);
+                if (depotEvery > 0 && i % depotEvery == depotEvery - 1) { route.push_back(0); }
+            }
+            route.push_back(0);
+            double assignTime[2], amendTime[2];
+            std::vector<RepositionSchemeTRK> amended[2];
+            for (int layout = 0; layout < 2; layout++) {
+                LoadProfile::treeThreshold = layout == 0 ? flatThreshold : treeThreshold;
+                std::vector<int> usable(nbStations + 1), broken(nbStations + 1);
+                std::vector<RepositionSchemeTRK> scheme;
+                assignTime[layout] = timeIt(repeats, [&] {
+                    for (int s = 1; s <= nbStations; s++) {
+                        usable[s] = instance.networkInfo[s].usableBike;
+                        broken[s] = instance.networkInfo[s].brokenBike;
+                    }
+                    std::vector<int> assigned = route;
+                    assignTruckScheme(params, assigned, usable, broken, instance, scheme);
+                });
+                amendTime[layout] = timeIt(repeats, [&] {
+                    amended[layout] = scheme;
+                    std::vector<int> amendedUsable = usable, amendedBroken = broken;
+                    truckSchemeAmendment(params, amended[layout], amendedUsable, amendedBroken, instance);
+                });
+            }
+            for (std::size_t i = 0; i < amended[0].size(); i++) {
+                if (amended[0][i].loadingQuantityU != amended[1][i].loadingQuantityU
+                    || amended[0][i].unloadingQuantityU != amended[1][i].unloadingQuantityU
+                    || amended[0][i].loadingQuantityB != amended[1][i].loadingQuantityB
+                    || amended[0][i].unloadingQuantityB != amended[1][i].unloadingQuantityB
+                    || amended[0][i].truckUQ != amended[1][i].truckUQ
+                    || amended[0][i].truckBQ != amended[1][i].truckBQ) {
+                    std::cerr << "flat and tree amendments disagree" << std::endl;
+                    return 1;
+                }
+            }
+            bool defaultFlat = LoadProfile::longestSpan(route) < defaultThreshold;
+            std::cout << "    " << (depotEvery > 0 ? "depot every 20 stops" : "no depot until the end") << " ("
+                      << (defaultFlat ? "flat" : "tree") << " by default): assignTruckScheme flat " << assignTime[0]
+                      << " us, tree " << assignTime[1] << " us; truckSchemeAmendment flat " << amendTime[0]
+                      << " us, tree " << amendTime[1] << " us" << std::endl;
+        }
+    }
+    return 0;
+}
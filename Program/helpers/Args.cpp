@@ -1,5 +1,6 @@
 #include "Args.h"
 #include "cmdparser.hpp"
+#include <algorithm>
 
 // options: --nbStns (default 10, options 10, 20, 30, 60, 120, 200, 300, 400,
 // 500), --nbTrk (default 1, options 1, 2, 3, 4, 5), --nbRpm (default 1, options
@@ -27,6 +28,19 @@ int vehicleCapacity;
 bool isProportion;
 double timeBudget;
 int itEDU;
+bool compileBinary;
+bool textInstance;
+int loadThreads;
+bool sharedInstance;
+bool unlinkShared;
+std::string instanceStream;
+int repairmanCache;
+bool fleetMoves;
+int evaluationCache;
+bool leanIndividuals;
+bool singlePass;
+bool repairKnapsack;
+int neighbors;
 
 void parseArgs(int argc, char *argv[]) {
   cli::Parser parser(argc, argv);
@@ -62,6 +76,46 @@ void parseArgs(int argc, char *argv[]) {
   parser.set_optional<int>(
       "edu", "itedu", 40,
       "number of iterations repeated when an operator improved a solution");
+  parser.set_optional<bool>(
+      "cbin", "compile_binary", false,
+      "compile the instance text files into a binary image and exit");
+  parser.set_optional<bool>(
+      "txt", "text_instance", false,
+      "read the instance from the text files even if a binary image exists");
+  parser.set_optional<int>(
+      "lthr", "load_threads", 0,
+      "threads parsing the instance text files (0: one per hardware thread)");
+  parser.set_optional<bool>(
+      "shm", "shared_instance", false,
+      "share the instance tables with other solver processes via shared memory");
+  parser.set_optional<bool>(
+      "shmrm", "unlink_shared", false,
+      "remove the shared-memory segment of the instance and exit");
+  parser.set_optional<std::string>(
+      "in", "instance_stream", "",
+      "read the instance from a packed instance stream ('-' for stdin)");
+  parser.set_optional<int>(
+      "rpmc", "repairman_cache", 1024,
+      "repairmen assignments kept in the LRU cache (0: no cache)");
+  parser.set_optional<bool>(
+      "fmv", "fleet_moves", false,
+      "local search moves perturb the trucks or the repairmen, not both");
+  parser.set_optional<int>(
+      "evc", "eval_cache", 1024,
+      "slots of the cache of evaluated individuals (0: no cache)");
+  parser.set_optional<bool>(
+      "lean", "lean_individuals", false,
+      "keep the population without the schemes, rebuilt for the best solution");
+  parser.set_optional<bool>(
+      "spa", "single_pass", false,
+      "assign the schemes of each route in one pass, without the re-runs");
+  parser.set_optional<bool>(
+      "rks", "repair_knapsack", false,
+      "allocate the repair time of each repairman route by a knapsack");
+  parser.set_optional<int>(
+      "nbk", "neighbors", 0,
+      "closest stations of each station the construction and the insertions "
+      "draw from (0: every station)");
   parser.set_optional<bool>("help", "help", false, "show help message");
   parser.run_and_exit_if_error();
 
@@ -82,6 +136,19 @@ void parseArgs(int argc, char *argv[]) {
   repairTime = parser.get<int>("rpT");
   vehicleCapacity = parser.get<int>("vcap");
   itEDU = parser.get<int>("edu");
+  compileBinary = parser.get<bool>("cbin");
+  textInstance = parser.get<bool>("txt");
+  loadThreads = parser.get<int>("lthr");
+  sharedInstance = parser.get<bool>("shm");
+  unlinkShared = parser.get<bool>("shmrm");
+  instanceStream = parser.get<std::string>("in");
+  repairmanCache = std::max(parser.get<int>("rpmc"), 0);
+  fleetMoves = parser.get<bool>("fmv");
+  evaluationCache = std::max(parser.get<int>("evc"), 0);
+  leanIndividuals = parser.get<bool>("lean");
+  singlePass = parser.get<bool>("spa");
+  repairKnapsack = parser.get<bool>("rks");
+  neighbors = std::max(parser.get<int>("nbk"), 0);
   isProportion = brokenProp >= 0;
   // if timeBudget is not provided, then timeBudget is set based on the number
   // of stations, the mapping is as follows: 6, 10, or 15: 7200; 20,30: 10800;
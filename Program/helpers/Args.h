@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 // options: --nbStns (default 10, options 10, 20, 30, 60, 120, 200, 300, 400,
 // 500), --nbTrk (default 1, options 1, 2, 3, 4, 5), --nbRpm (default 1, options
 // 1, 2, 3), --nbInst (default 1, options 0 to 100), --penalty (default 10,
@@ -25,6 +26,19 @@ namespace Args {
     extern int penaltyCapacity;
     extern bool isProportion;
     extern int itEDU;
+    extern bool compileBinary;
+    extern bool textInstance;
+    extern int loadThreads;
+    extern bool sharedInstance;
+    extern bool unlinkShared;
+    extern std::string instanceStream;
+    extern int repairmanCache;
+    extern bool fleetMoves;
+    extern int evaluationCache;
+    extern bool leanIndividuals;
+    extern bool singlePass;
+    extern bool repairKnapsack;
+    extern int neighbors;
 
     void parseArgs(int argc, char *argv[]);
 } // namespace Args
\ No newline at end of file
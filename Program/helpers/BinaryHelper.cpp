@@ -0,0 +1,230 @@
+#include "BinaryHelper.h"
+#include "../Instance.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace BinaryHelper {
+    namespace {
+        static_assert(sizeof(ImageHeader) % 8 == 0, "the header checksum is chained into the one of the sections");
+
+        constexpr std::uint64_t align8(std::uint64_t offset) { return (offset + 7) & ~std::uint64_t{7}; }
+
+        std::uint64_t triangleSize(int capacity) { return StationTable::cellsOf(capacity); }
+
+        // byte length of count items of the given width, saturated so that a corrupted count cannot wrap around
+        std::uint64_t sectionBytes(std::uint64_t count, std::uint64_t width) {
+            return count > UINT64_MAX / width ? UINT64_MAX : count * width;
+        }
+
+        // every section must be 8-byte aligned, follow the previous one and end inside the image, the last one
+        // exactly at its end
+        bool sectionsFit(const ImageHeader &header, std::size_t size) {
+            const auto n = static_cast<std::uint64_t>(header.nbClients);
+            const std::uint64_t sections[][2] = {
+                {header.stationOffset, sectionBytes(4 * n, sizeof(std::int32_t))},
+                {header.distOffset, sectionBytes((n + 1) * (n + 1), sizeof(double))},
+                {header.dissatOffset, sectionBytes(header.tableSize, sizeof(double))},
+                {header.priorityOffset, sectionBytes(header.tableSize, sizeof(double))},
+                {header.priorityROffset, sectionBytes(header.tableSize, sizeof(double))},
+            };
+            std::uint64_t end = sizeof(ImageHeader);
+            for (const auto &[offset, bytes] : sections) {
+                if (offset % 8 != 0 || offset < end || offset > size || bytes > size - offset) { return false; }
+                end = offset + bytes;
+            }
+            return end == size;
+        }
+    } // namespace
+
+    std::uint64_t checksum(const std::byte *data, std::size_t size, std::uint64_t seed) {
+        std::uint64_t hash = seed;
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        if (i < size) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, data + i, size - i);
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    std::uint64_t sourceFingerprint(const std::string &folder, int nbClients) {
+        std::vector<std::uint64_t> words;
+        words.reserve(6 * static_cast<std::size_t>(nbClients) + 4);
+        auto addFile = [&](const std::string &filename) {
+            std::error_code error;
+            std::uint64_t size = std::filesystem::file_size(folder + filename, error);
+            if (error) { size = UINT64_MAX; }
+            auto modified = std::filesystem::last_write_time(folder + filename, error);
+            words.push_back(size);
+            words.push_back(error ? 0 : static_cast<std::uint64_t>(modified.time_since_epoch().count()));
+        };
+
+        addFile("station_info_" + std::to_string(nbClients) + ".txt");
+        if (words.front() == UINT64_MAX) { return 0; }
+        addFile("time_matrix_" + std::to_string(nbClients) + ".txt");
+        for (int i = 1; i <= nbClients; i++) {
+            for (const char *prefix : {"dissat_table_", "BCRF_", "BCRFR_"}) {
+                addFile(prefix + std::to_string(i) + ".txt");
+            }
+        }
+        std::uint64_t fingerprint =
+            checksum(reinterpret_cast<const std::byte *>(words.data()), words.size() * sizeof(std::uint64_t));
+        return fingerprint == 0 ? 1 : fingerprint;
+    }
+
+    std::vector<std::byte> buildImage(const Instance &instance) {
+        const int n = instance.nbClients;
+        std::vector<std::int32_t> stations;
+        stations.reserve(4 * n);
+        for (int i = 1; i <= n; i++) {
+            const Station &station = instance.networkInfo[i];
+            stations.insert(stations.end(), {station.capacity, station.usableBike, station.targetUsable,
+                                                station.brokenBike});
+        }
+
+        const Matrix<double> &distances = instance.dist_mtx;
+        if (distances.nbRows() != n + 1 || distances.nbCols() != n + 1) { return {}; }
+
+        // the tables are already laid out as in the image
+        const StationTable &dissat = instance.dissatTable;
+        const StationTable &priority = instance.priorityTable;
+        const StationTable &priorityR = instance.priorityTableR;
+
+        ImageHeader header{};
+        std::memcpy(header.magic, imageMagic, sizeof(imageMagic));
+        header.version = imageVersion;
+        header.byteOrder = byteOrderTag;
+        header.nbClients = n;
+        header.sourceFingerprint = sourceFingerprint(instance.pathToInstance, n);
+        header.stationOffset = align8(sizeof(ImageHeader));
+        header.distOffset = align8(header.stationOffset + stations.size() * sizeof(std::int32_t));
+        header.tableSize = dissat.size();
+        header.dissatOffset = header.distOffset + distances.size() * sizeof(double);
+        header.priorityOffset = header.dissatOffset + header.tableSize * sizeof(double);
+        header.priorityROffset = header.priorityOffset + header.tableSize * sizeof(double);
+        header.fileSize = header.priorityROffset + header.tableSize * sizeof(double);
+
+        std::vector<std::byte> image(header.fileSize);
+        std::memcpy(image.data() + header.stationOffset, stations.data(), stations.size() * sizeof(std::int32_t));
+        std::memcpy(image.data() + header.distOffset, distances.data(), distances.size() * sizeof(double));
+        std::memcpy(image.data() + header.dissatOffset, dissat.data(), header.tableSize * sizeof(double));
+        std::memcpy(image.data() + header.priorityOffset, priority.data(), header.tableSize * sizeof(double));
+        std::memcpy(image.data() + header.priorityROffset, priorityR.data(), header.tableSize * sizeof(double));
+        std::memcpy(image.data(), &header, sizeof(ImageHeader));
+        header.checksum = checksum(image.data(), image.size());
+        std::memcpy(image.data(), &header, sizeof(ImageHeader));
+        return image;
+    }
+
+    bool writeImage(const Instance &instance, const std::string &filepath) {
+        std::vector<std::byte> image = buildImage(instance);
+        if (image.empty()) { return false; }
+
+        // write to a temporary file first so that a concurrent reader never sees a half written image
+        std::string tmpPath = filepath + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) { return false; }
+            out.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+            if (!out) { return false; }
+        }
+        return std::rename(tmpPath.c_str(), filepath.c_str()) == 0;
+    }
+
+    std::string compileInstance(int nbClient, const std::string &instNo, int nbLoadThreads,
+        const std::string &filepath) {
+        // the image stores the raw station info, the broken proportion is applied when the image is read
+        Instance source(nbClient, instNo, 0., false, false, nbLoadThreads);
+        std::string imagePath = filepath.empty() ? source.binaryPath() : filepath;
+        return writeImage(source, imagePath) ? imagePath : std::string();
+    }
+
+    bool readImage(Instance &instance, const std::string &filepath) {
+        std::ifstream probe(filepath);
+        if (!probe) { return false; }
+        probe.close();
+
+        auto mapped = std::make_shared<const MappedFile>(filepath);
+        std::uint64_t fingerprint = sourceFingerprint(instance.pathToInstance, instance.nbClients);
+        if (!loadImage(instance, mapped->data(), mapped->size(), "Compiled instance " + filepath, fingerprint)) {
+            return false;
+        }
+        // the tables are used in place, the instance keeps the mapping alive
+        instance.image = mapped;
+        return true;
+    }
+
+    bool loadImage(Instance &instance, const std::byte *data, std::size_t size, const std::string &source,
+        std::uint64_t fingerprint) {
+        if (size < sizeof(ImageHeader)) {
+            std::cerr << source << " is truncated, ignoring it" << std::endl;
+            return false;
+        }
+        ImageHeader header{};
+        std::memcpy(&header, data, sizeof(ImageHeader));
+        if (std::memcmp(header.magic, imageMagic, sizeof(imageMagic)) != 0 || header.byteOrder != byteOrderTag
+            || header.version != imageVersion) {
+            std::cerr << source << " has an unsupported format (version " << header.version << ", expected "
+                      << imageVersion << "), ignoring it" << std::endl;
+            return false;
+        }
+        const int n = header.nbClients;
+        if (n != instance.nbClients || header.fileSize != size || !sectionsFit(header, size)) {
+            std::cerr << source << " does not match the instance, ignoring it" << std::endl;
+            return false;
+        }
+        ImageHeader unsealed = header;
+        unsealed.checksum = 0;
+        std::uint64_t headerChecksum = checksum(reinterpret_cast<const std::byte *>(&unsealed), sizeof(ImageHeader));
+        if (checksum(data + sizeof(ImageHeader), size - sizeof(ImageHeader), headerChecksum) != header.checksum) {
+            std::cerr << source << " fails its checksum, ignoring it" << std::endl;
+            return false;
+        }
+        if (fingerprint != 0 && header.sourceFingerprint != fingerprint) {
+            std::cerr << source << " was compiled from other versions of the text files, ignoring it" << std::endl;
+            return false;
+        }
+
+        auto stations = reinterpret_cast<const std::int32_t *>(data + header.stationOffset);
+        auto distances = reinterpret_cast<const double *>(data + header.distOffset);
+        auto dissat = reinterpret_cast<const double *>(data + header.dissatOffset);
+        auto priority = reinterpret_cast<const double *>(data + header.priorityOffset);
+        auto priorityR = reinterpret_cast<const double *>(data + header.priorityROffset);
+
+        std::uint64_t expectedTableSize = 0;
+        bool validCapacities = true;
+        for (int i = 0; i < n; i++) {
+            validCapacities = validCapacities && stations[4 * i] >= 0;
+            expectedTableSize += triangleSize(stations[4 * i]);
+        }
+        if (!validCapacities || expectedTableSize != header.tableSize) {
+            std::cerr << source << " has inconsistent tables, ignoring it" << std::endl;
+            return false;
+        }
+
+        instance.networkInfo.clear();
+        instance.networkInfo.reserve(n + 1);
+        instance.networkInfo.emplace_back(0, INT_MAX, 0, INT_MAX, INT_MAX);
+        for (int i = 0; i < n; i++) {
+            instance.addStation(stations[4 * i], stations[4 * i + 1], stations[4 * i + 2], stations[4 * i + 3]);
+        }
+
+        instance.dist_mtx.assign(n + 1, n + 1);
+        std::memcpy(instance.dist_mtx.data(), distances, sizeof(double) * instance.dist_mtx.size());
+        instance.computeRepairmanTimes();
+
+        instance.dissatTable.adopt(instance.networkInfo, dissat);
+        instance.priorityTable.adopt(instance.networkInfo, priority);
+        instance.priorityTableR.adopt(instance.networkInfo, priorityR);
+        return true;
+    }
+} // namespace BinaryHelper
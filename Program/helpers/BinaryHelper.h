@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Instance;
+
+// Compiled (binary) instance image. One image holds everything the text files of an instance folder hold: station
+// info, the time matrix and the dissatisfaction / BCRF / BCRFR tables of every station. Tables are stored
+// triangularly (row p holds the columns b = 0..C-p, since cells with p + b > C are padding in the text files).
+//
+// Layout: ImageHeader, then the payload sections at the offsets recorded in the header, each 8-byte aligned.
+//   stations   int32[nbClients][4]    capacity, usable, target usable, broken (raw values of station_info_N)
+//   distances  double[nbClients + 1][nbClients + 1]
+//   dissat     double[tableSize]      triangular rows of station 1, then station 2, ...
+//   priority   double[tableSize]
+//   priorityR  double[tableSize]
+// The header records the sizes and modification times of the text files the image was compiled from, an image that
+// no longer matches them is ignored.
+namespace BinaryHelper {
+    constexpr char imageMagic[8] = {'B', 'R', 'P', 'W', 'R', 'I', 'M', 'G'};
+    constexpr std::uint32_t imageVersion = 2;
+    constexpr std::uint32_t byteOrderTag = 0x01020304;
+
+    struct ImageHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::int32_t nbClients;
+        std::int32_t reserved;
+        std::uint64_t fileSize;
+        std::uint64_t checksum; // checksum of the whole image, this field counting as zero
+        std::uint64_t stationOffset;
+        std::uint64_t distOffset;
+        std::uint64_t dissatOffset;
+        std::uint64_t priorityOffset;
+        std::uint64_t priorityROffset;
+        std::uint64_t tableSize; // number of doubles in each of the three tables
+        std::uint64_t sourceFingerprint; // see sourceFingerprint
+    };
+
+    constexpr std::uint64_t checksumSeed = 14695981039346656037ULL;
+
+    // FNV-1a over 64-bit words (the tail is zero-padded), good enough to catch truncated or corrupted images. The
+    // seed chains the checksums of consecutive blocks whose sizes are multiples of 8.
+    std::uint64_t checksum(const std::byte *data, std::size_t size, std::uint64_t seed = checksumSeed);
+
+    // Fingerprint of the text files of an instance folder: the size and modification time of the time matrix, the
+    // station info and every station table. 0 when the folder has no station info, an image is then used as is.
+    std::uint64_t sourceFingerprint(const std::string &folder, int nbClients);
+
+    // Serializes the instance into an image (empty if the instance is inconsistent); the instance must have been
+    // loaded without the broken proportion so that the raw station info is stored.
+    std::vector<std::byte> buildImage(const Instance &instance);
+
+    // Writes the compiled image of the instance, see buildImage
+    bool writeImage(const Instance &instance, const std::string &filepath);
+
+    // Compiles the text files of an instance folder into its binary image (or into filepath when given), returns the
+    // path of the written image or an empty string on failure.
+    std::string compileInstance(int nbClient, const std::string &instNo, int nbLoadThreads = 0,
+        const std::string &filepath = "");
+
+    // Fills the instance from a compiled image, the station tables point straight into the mapped file. Returns
+    // false, leaving the instance untouched, when the image does not exist or does not match (bad magic, version,
+    // size, section offsets, checksum, station count or text files of instance.pathToInstance); the caller then
+    // falls back to the text files.
+    bool readImage(Instance &instance, const std::string &filepath);
+
+    // Fills the instance from an image held in memory, with the same checks as readImage except that the source
+    // fingerprint is only compared when one (non zero) is given; the station tables point into data, which the caller
+    // keeps alive (Instance::image). source names the image in the error messages.
+    bool loadImage(Instance &instance, const std::byte *data, std::size_t size, const std::string &source,
+        std::uint64_t fingerprint = 0);
+} // namespace BinaryHelper
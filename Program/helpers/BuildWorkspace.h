@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../RepositionScheme.h"
+#include "LoadProfile.h"
+#include "RepInfo.h"
+#include "alias.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Scratch buffers of an individual build (buildIndividual and the assignment functions of Utils). A build only needs
+// them while it runs, so every thread keeps one workspace whose buffers are cleared or reassigned, never freed:
+// once they have grown to the size of the largest build, building an individual allocates nothing but the routes
+// and schemes of a new individual and the cache entries (the trace is recycled, see BuildTrace.h). Each buffer
+// belongs to a single function, so that the functions calling each other never share one.
+struct BuildWorkspace {
+    // inventories of the stations while the routes are assigned (Individual constructors, materializeSchemes)
+    std::vector<int> usable;
+    std::vector<int> broken;
+    // inventories before the first route of a fleet, restored when a route is assigned again
+    // (greedyAssignmentForRepairman, greedyAssignmentForTrucks)
+    std::vector<int> usableBak;
+    std::vector<int> brokenBak;
+    // stations assigned so far (inventoryAfter)
+    std::vector<int> assignedStations;
+    // stations of the repairmen routes (buildIndividual)
+    std::vector<bool> inRepairmanRoute;
+    // stations not visited yet by the random repairmen routes (rpmRouteInit)
+    std::vector<int> unvisitedStations;
+
+    // assignTruckScheme and assignRepairmanScheme
+    std::vector<double> maxOpTime;
+    std::vector<double> priority;
+    std::vector<int> usableBackup;
+    std::vector<int> brokenBackup;
+    std::vector<double> maxOpTimeBackup;
+    UnsatList unSatLdStationU;
+    UnsatList unSatLdStationB;
+    UnsatList unSatUldStationU;
+    std::vector<std::pair<int, double>> uldExtraTime;
+    // greedyAssignment
+    LoadProfile truckLoads;
+    // allocateRepairTime
+    std::vector<int> repairStops;
+    std::vector<int> gainCurveStart;
+    std::vector<double> repairGain;
+    std::vector<double> bestGain;
+    std::vector<double> nextGain;
+    std::vector<int> repairChoice;
+
+    // getMaxOpTime and routeAdjustment
+    std::vector<int> routeStations;
+    std::vector<StationInfo> stationInfo;
+    std::vector<std::pair<int, double>> stationIDAndPriority;
+
+    // repairmanSchemeAmendment and truckSchemeAmendment
+    std::vector<std::pair<int, double>> repairPriority;
+    std::vector<std::pair<int, double>> repairableStation;
+    std::vector<int> insertionCandidates;
+    std::vector<char> isInsertionCandidate;
+    std::vector<std::tuple<int, int, double>> truckPriority;
+    LoadProfile amendmentLoads;
+    std::vector<int> nextDepot;
+    std::vector<int> nextReceiver;
+
+    // feasibilityCheckOfSolution
+    std::vector<int> finalUsable;
+    std::vector<int> finalBroken;
+    std::vector<RepositionEvent> routeEvents;
+    std::vector<std::size_t> routeBounds;
+    std::vector<int> owner;
+    std::vector<int> visitedStations;
+    std::vector<std::size_t> sharedVisits;
+
+    // the workspace of the calling thread
+    static BuildWorkspace &local() {
+        thread_local BuildWorkspace workspace;
+        return workspace;
+    }
+};
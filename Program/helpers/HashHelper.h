@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 64-bit hashes of the routes of a chromosome, for the caches keyed by routes
+namespace HashHelper {
+    constexpr std::uint64_t fnvOffset = 14695981039346656037ULL;
+    constexpr std::uint64_t fnvPrime = 1099511628211ULL;
+
+    // FNV-1a over the stations of the route (one step per station), followed by a separator so that moving a station
+    // to the next route changes the hash
+    inline std::uint64_t mixRoute(std::uint64_t hash, const std::vector<int> &route) {
+        for (int station : route) { hash = (hash ^ static_cast<std::uint32_t>(station)) * fnvPrime; }
+        return (hash ^ 0xFFFFFFFFULL) * fnvPrime;
+    }
+
+    inline std::uint64_t hashRoutes(const std::vector<std::vector<int>> &routes, std::uint64_t hash = fnvOffset) {
+        for (const auto &route : routes) { hash = mixRoute(hash, route); }
+        return hash;
+    }
+} // namespace HashHelper
@@ -0,0 +1,164 @@
+#include "LoadProfile.h"
+#include <climits>
+
+namespace {
+    // load of the leaves past the last stop, below every real load so that they never are the largest
+    constexpr int noStop = INT_MIN / 2;
+} // namespace
+
+std::size_t LoadProfile::longestSpan(const std::vector<int> &route) {
+    std::size_t longest = 0, span = 0;
+    for (int station : route) {
+        span = station == 0 ? 0 : span + 1;
+        longest = std::max(longest, span);
+    }
+    return longest;
+}
+
+void LoadProfile::reset(int truckCapacity, std::size_t maxStops, std::size_t longestSpan) {
+    capacity = truckCapacity;
+    nbStops = 0;
+    flat = longestSpan < treeThreshold;
+    if (flat) {
+        addedUsable.resize(maxStops);
+        addedBroken.resize(maxStops);
+        return;
+    }
+    leaves = 1;
+    while (leaves < maxStops) { leaves *= 2; }
+    load.assign(2 * leaves, noStop);
+    addedUsable.assign(2 * leaves, 0);
+    addedBroken.assign(2 * leaves, 0);
+}
+
+void LoadProfile::assign(int truckCapacity, const std::vector<RepositionSchemeTRK> &rSchemeVec) {
+    std::size_t longest = 0, span = 0;
+    for (const RepositionSchemeTRK &stop : rSchemeVec) {
+        span = stop.station == 0 ? 0 : span + 1;
+        longest = std::max(longest, span);
+    }
+    reset(truckCapacity, rSchemeVec.size(), longest);
+    nbStops = rSchemeVec.size();
+    std::size_t first = flat ? 0 : leaves;
+    for (std::size_t stop = 0; stop < nbStops; stop++) {
+        addedUsable[first + stop] = rSchemeVec[stop].truckUQ;
+        addedBroken[first + stop] = rSchemeVec[stop].truckBQ;
+    }
+    if (flat) { return; }
+    for (std::size_t stop = 0; stop < nbStops; stop++) {
+        load[leaves + stop] = rSchemeVec[stop].truckUQ + rSchemeVec[stop].truckBQ;
+    }
+    for (std::size_t node = leaves - 1; node >= 1; node--) { pull(node); }
+}
+
+void LoadProfile::push(int usable, int broken) {
+    if (flat) {
+        addedUsable[nbStops] = usable;
+        addedBroken[nbStops] = broken;
+        nbStops++;
+        return;
+    }
+    // no addition covers the stops past the last one, the leaf holds the whole load
+    std::size_t node = leaves + nbStops++;
+    addedUsable[node] = usable;
+    addedBroken[node] = broken;
+    load[node] = usable + broken;
+    for (node /= 2; node >= 1; node /= 2) { pull(node); }
+}
+
+int LoadProfile::usable(std::size_t stop) const {
+    if (flat) { return addedUsable[stop]; }
+    int bikes = 0;
+    for (std::size_t node = leaves + stop; node >= 1; node /= 2) { bikes += addedUsable[node]; }
+    return bikes;
+}
+
+int LoadProfile::broken(std::size_t stop) const {
+    if (flat) { return addedBroken[stop]; }
+    int bikes = 0;
+    for (std::size_t node = leaves + stop; node >= 1; node /= 2) { bikes += addedBroken[node]; }
+    return bikes;
+}
+
+int LoadProfile::minResidual(std::size_t first, std::size_t last) const {
+    if (first >= last) { return capacity; }
+    if (!flat) { return capacity - maxLoad(first, last); }
+    int largestLoad = addedUsable[first] + addedBroken[first];
+    for (std::size_t stop = first + 1; stop < last; stop++) {
+        largestLoad = std::max(largestLoad, addedUsable[stop] + addedBroken[stop]);
+    }
+    return capacity - largestLoad;
+}
+
+void LoadProfile::addUsable(std::size_t first, std::size_t last, int bikes) {
+    if (!flat) {
+        if (first < last) { add(first, last, bikes, 0); }
+        return;
+    }
+    for (std::size_t stop = first; stop < last; stop++) { addedUsable[stop] += bikes; }
+}
+
+void LoadProfile::addBroken(std::size_t first, std::size_t last, int bikes) {
+    if (!flat) {
+        if (first < last) { add(first, last, 0, bikes); }
+        return;
+    }
+    for (std::size_t stop = first; stop < last; stop++) { addedBroken[stop] += bikes; }
+}
+
+void LoadProfile::writeTo(std::vector<RepositionSchemeTRK> &rSchemeVec) const {
+    if (!flat) {
+        if (nbStops > 0) { writeTo(1, 0, leaves, 0, 0, rSchemeVec); }
+        return;
+    }
+    for (std::size_t stop = 0; stop < nbStops; stop++) {
+        rSchemeVec[stop].truckUQ = addedUsable[stop];
+        rSchemeVec[stop].truckBQ = addedBroken[stop];
+    }
+}
+
+void LoadProfile::add(std::size_t first, std::size_t last, int usableBikes, int brokenBikes) {
+    // the bikes are added to the nodes covering [first, last) bottom-up, then the loads of the nodes above the two
+    // ends of the range, the only ones partly covered, are pulled up again
+    for (std::size_t l = first + leaves, r = last + leaves; l < r; l /= 2, r /= 2) {
+        if (l & 1) { addTo(l++, usableBikes, brokenBikes); }
+        if (r & 1) { addTo(--r, usableBikes, brokenBikes); }
+    }
+    for (std::size_t node = (first + leaves) / 2; node >= 1; node /= 2) { pull(node); }
+    for (std::size_t node = (last - 1 + leaves) / 2; node >= 1; node /= 2) { pull(node); }
+}
+
+int LoadProfile::maxLoad(std::size_t first, std::size_t last) const {
+    // the nodes covering [first, last) are taken bottom-up, those taken on the left are all below the node left of l
+    // and those taken on the right below r, so the additions of these two nodes are added to the largest loads at
+    // each level. A side with no node taken adds the additions of nodes off the range to noStop, which stays below
+    // every load
+    int left = noStop, right = noStop;
+    std::size_t l = first + leaves, r = last + leaves;
+    while (l < r) {
+        if (l & 1) { left = std::max(left, load[l++]); }
+        if (r & 1) { right = std::max(right, load[--r]); }
+        l /= 2;
+        r /= 2;
+        left += addedLoad(l - 1);
+        right += addedLoad(r);
+    }
+    for (std::size_t node = l - 1; node > 1; node /= 2) { left += addedLoad(node / 2); }
+    for (std::size_t node = r; node > 1; node /= 2) { right += addedLoad(node / 2); }
+    return std::max(left, right);
+}
+
+void LoadProfile::writeTo(std::size_t node, std::size_t lo, std::size_t hi, int usableBikes, int brokenBikes,
+    std::vector<RepositionSchemeTRK> &rSchemeVec) const {
+    if (lo >= nbStops) { return; }
+    usableBikes += addedUsable[node];
+    brokenBikes += addedBroken[node];
+    if (hi - lo == 1) {
+        rSchemeVec[lo].truckUQ = usableBikes;
+        rSchemeVec[lo].truckBQ = brokenBikes;
+        return;
+    }
+    std::size_t mid = (lo + hi) / 2;
+    writeTo(2 * node, lo, mid, usableBikes, brokenBikes, rSchemeVec);
+    writeTo(2 * node + 1, mid, hi, usableBikes, brokenBikes, rSchemeVec);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../RepositionScheme.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Usable and broken bikes on board of a truck after each stop of its scheme, while the quantities of the scheme are
+// assigned or amended. Loading bikes at a stop and unloading them at a later one adds them to the load of every stop
+// in between, and a load can only be added where the truck has room left on that whole range, so both the update
+// and the query are over a range of stops. A segment tree with lazy additions does each in O(log L) for L stops.
+// The additions are kept in the nodes they cover and never pushed down: a load is the sum of the additions on the
+// path from the root to its leaf. Most ranges end at the next depot, where the truck is empty, so a scheme with
+// short runs of stops between depots keeps its loads in two flat arrays instead, scanned in O(L): bench_load_profile
+// times both layouts, the flat one wins at every length with a depot every 20 stops and the tree only gets ahead
+// from about 400 stops without a depot. Truck routes within the usual time budgets have 15 to 30 stops.
+class LoadProfile {
+public:
+    // shortest run of stops without a depot kept in the tree, bench_load_profile moves it to time both layouts
+    inline static std::size_t treeThreshold = 400;
+
+    // Longest run of stops without a depot in a route
+    static std::size_t longestSpan(const std::vector<int> &route);
+
+    // Empties the profile of a truck of the given capacity, for schemes of at most maxStops stops with at most
+    // longestSpan stops in a row without a depot
+    void reset(int capacity, std::size_t maxStops, std::size_t longestSpan);
+    // Loads the truck loads of a whole scheme
+    void assign(int capacity, const std::vector<RepositionSchemeTRK> &rSchemeVec);
+    // Appends a stop leaving usable and broken bikes on board
+    void push(int usable, int broken);
+
+    std::size_t size() const { return nbStops; }
+    int usable(std::size_t stop) const;
+    int broken(std::size_t stop) const;
+    // Room left on board after every stop of [first, last), the capacity if the range is empty
+    int minResidual(std::size_t first, std::size_t last) const;
+    // Adds bikes on board after every stop of [first, last)
+    void addUsable(std::size_t first, std::size_t last, int bikes);
+    void addBroken(std::size_t first, std::size_t last, int bikes);
+
+    // Writes the loads to the truckUQ and truckBQ of the scheme, in O(L)
+    void writeTo(std::vector<RepositionSchemeTRK> &rSchemeVec) const;
+
+private:
+    int addedLoad(std::size_t node) const { return addedUsable[node] + addedBroken[node]; }
+    void addTo(std::size_t node, int usableBikes, int brokenBikes) {
+        addedUsable[node] += usableBikes;
+        addedBroken[node] += brokenBikes;
+        load[node] += usableBikes + brokenBikes;
+    }
+    void pull(std::size_t node) { load[node] = std::max(load[2 * node], load[2 * node + 1]) + addedLoad(node); }
+    void add(std::size_t first, std::size_t last, int usableBikes, int brokenBikes);
+    int maxLoad(std::size_t first, std::size_t last) const;
+    void writeTo(std::size_t node, std::size_t lo, std::size_t hi, int usableBikes, int brokenBikes,
+        std::vector<RepositionSchemeTRK> &rSchemeVec) const;
+
+    int capacity = 0;
+    bool flat = true;       // addedUsable and addedBroken are the loads after each stop, the tree is not used
+    std::size_t leaves = 0; // the tree covers the stops [0, leaves), leaves is a power of two
+    std::size_t nbStops = 0;
+    std::vector<int> load;        // largest load after a stop of the node, without the additions of its ancestors
+    std::vector<int> addedUsable; // usable bikes added after every stop of the node
+    std::vector<int> addedBroken; // broken bikes added after every stop of the node
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. On POSIX systems the file is memory-mapped, so the pages are shared with the page
+// cache and with every other process mapping the same file; elsewhere it falls back to reading the file into memory.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &filepath);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const std::byte *data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const std::byte *bytes = nullptr;
+    std::size_t length = 0;
+#if defined(_WIN32)
+    std::vector<std::byte> buffer;
+#endif
+};
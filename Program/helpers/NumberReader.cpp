@@ -0,0 +1,36 @@
+#include "NumberReader.h"
+#include <algorithm>
+#include <fstream>
+
+void NumberReader::open(const std::string &filepath) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file) { throw std::runtime_error("Could not open file: " + filepath); }
+    auto size = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+    read(file, size, filepath);
+}
+
+void NumberReader::read(std::istream &in, std::size_t length, const std::string &name) {
+    filename = name;
+    if (buffer.size() < length) { buffer.resize(length); }
+    in.read(buffer.data(), static_cast<std::streamsize>(length));
+    if (static_cast<std::size_t>(in.gcount()) != length) {
+        throw std::runtime_error("Unexpected end of data while reading " + name);
+    }
+    pos = buffer.data();
+    end = buffer.data() + length;
+}
+
+void NumberReader::skipLine() {
+    pos = std::find(pos, end, '\n');
+    if (pos < end) { ++pos; }
+}
+
+bool NumberReader::atEnd() {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n')) { ++pos; }
+    return pos == end;
+}
+
+int NumberReader::lineNumber() const {
+    return 1 + static_cast<int>(std::count(static_cast<const char *>(buffer.data()), pos, '\n'));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <charconv>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Reads whitespace separated numbers from a text file. The whole file is read into one buffer and the numbers are
+// parsed in place with std::from_chars, so there are no streams, no per-line strings and no per-row vectors. The
+// buffer is kept from one file to the next, so a reader used for many files only allocates when a file is larger
+// than every file before it.
+class NumberReader {
+public:
+    // Loads a file, throws if it cannot be read
+    void open(const std::string &filepath);
+    // Loads the next length bytes of a stream (one section of an instance stream), name is used in the errors;
+    // throws if the stream ends first
+    void read(std::istream &in, std::size_t length, const std::string &name);
+
+    // Parses the next number of the current line into value; returns false, without moving to the next line, if
+    // the current line has no number left. Throws on a malformed number.
+    template <typename T> bool nextInLine(T &value) {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) { ++pos; }
+        if (pos == end || *pos == '\n') { return false; }
+        auto [ptr, ec] = std::from_chars(pos, end, value);
+        if (ec != std::errc() || (ptr < end && *ptr != ' ' && *ptr != '\t' && *ptr != '\r' && *ptr != '\n')) {
+            throw std::runtime_error("Could not read a number from line " + std::to_string(lineNumber()) + " of "
+                                     + filename);
+        }
+        pos = ptr;
+        return true;
+    }
+
+    // Like nextInLine, but a missing number is an error
+    template <typename T> void expectInLine(T &value) {
+        if (!nextInLine(value)) {
+            throw std::runtime_error("Missing number on line " + std::to_string(lineNumber()) + " of " + filename);
+        }
+    }
+
+    // Moves past the end of the current line
+    void skipLine();
+    // Skips blank lines, returns true if nothing but whitespace is left
+    bool atEnd();
+    int lineNumber() const;
+
+private:
+    std::vector<char> buffer;
+    const char *pos = nullptr;
+    const char *end = nullptr;
+    std::string filename;
+};
@@ -0,0 +1,204 @@
+#include "ShmHelper.h"
+#include "../Instance.h"
+#include "BinaryHelper.h"
+
+#if defined(_WIN32)
+std::string ShmHelper::segmentName(int nbClient, const std::string &instNo) {
+    return "/brpwr_v" + std::to_string(BinaryHelper::imageVersion) + "_" + std::to_string(nbClient) + "_" + instNo;
+}
+
+bool ShmHelper::loadShared(Instance &, const std::string &, bool, int) { return false; }
+
+bool ShmHelper::unlinkShared(int, const std::string &) { return false; }
+#else
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace ShmHelper {
+    namespace {
+        constexpr std::uint32_t building = 0;
+        constexpr std::uint32_t ready = 1;
+        constexpr std::uint32_t failed = 2;
+
+        // the image starts on its own cache line, its sections stay 8-byte aligned
+        constexpr std::size_t imageOffset = 64;
+
+        struct SegmentHeader {
+            std::atomic<std::uint32_t> state; // building, ready or failed; a new segment is zero-filled (building)
+            std::int32_t creator;              // pid of the publishing process
+            std::uint64_t imageSize;
+        };
+        static_assert(sizeof(SegmentHeader) <= imageOffset);
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the state is shared between processes");
+
+        // how long a process waits for the publisher to size the segment, then to mark it ready
+        constexpr auto sizingTimeout = std::chrono::seconds(1);
+        constexpr auto readyTimeout = std::chrono::seconds(120);
+        constexpr auto pollInterval = std::chrono::milliseconds(10);
+
+        // Shared mapping of a segment, unmapped with the last instance referring to it
+        class Mapping {
+        public:
+            Mapping(int fd, std::size_t length, int protection) : length(length) {
+                void *addr = mmap(nullptr, length, protection, MAP_SHARED, fd, 0);
+                if (addr != MAP_FAILED) { bytes = static_cast<std::byte *>(addr); }
+            }
+            ~Mapping() {
+                if (bytes != nullptr) { munmap(bytes, length); }
+            }
+            Mapping(const Mapping &) = delete;
+            Mapping &operator=(const Mapping &) = delete;
+
+            std::byte *data() const { return bytes; }
+            std::size_t size() const { return length; }
+            SegmentHeader *header() const { return reinterpret_cast<SegmentHeader *>(bytes); }
+
+        private:
+            std::byte *bytes = nullptr;
+            std::size_t length;
+        };
+
+        enum class Attach { attached, missing, stale, unavailable };
+        enum class Publish { published, exists, failed };
+
+        bool processAlive(pid_t pid) { return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM); }
+
+        // waits until the segment behind fd is ready, returns its size or 0 if it is stale, -1 if waiting gave up
+        long long waitUntilReady(int fd, const std::string &name) {
+            auto start = std::chrono::steady_clock::now();
+            while (true) {
+                struct stat info {};
+                if (fstat(fd, &info) != 0) { return -1; }
+                auto waited = std::chrono::steady_clock::now() - start;
+                if (static_cast<std::size_t>(info.st_size) >= imageOffset) {
+                    Mapping head(fd, imageOffset, PROT_READ);
+                    if (head.data() == nullptr) { return -1; }
+                    std::uint32_t state = head.header()->state.load(std::memory_order_acquire);
+                    if (state == ready) { return info.st_size; }
+                    if (state == failed || !processAlive(head.header()->creator)) { return 0; }
+                    if (waited > readyTimeout) {
+                        std::cerr << "Shared instance " << name << " is still being published, giving up" << std::endl;
+                        return -1;
+                    }
+                } else if (waited > sizingTimeout) {
+                    // the publisher died between creating and sizing the segment
+                    return 0;
+                }
+                std::this_thread::sleep_for(pollInterval);
+            }
+        }
+
+        Attach attach(Instance &instance, const std::string &name, std::uint64_t fingerprint) {
+            int fd = shm_open(name.c_str(), O_RDONLY, 0);
+            if (fd < 0) { return errno == ENOENT ? Attach::missing : Attach::unavailable; }
+            long long size = waitUntilReady(fd, name);
+            if (size <= 0) {
+                close(fd);
+                return size == 0 ? Attach::stale : Attach::unavailable;
+            }
+            auto mapping = std::make_shared<const Mapping>(fd, static_cast<std::size_t>(size), PROT_READ);
+            // the mapping stays valid after the descriptor is closed
+            close(fd);
+            if (mapping->data() == nullptr) { return Attach::unavailable; }
+            std::uint64_t imageSize = mapping->header()->imageSize;
+            if (imageSize > mapping->size() - imageOffset
+                || !BinaryHelper::loadImage(
+                    instance, mapping->data() + imageOffset, imageSize, "Shared instance " + name, fingerprint)) {
+                return Attach::stale;
+            }
+            instance.image = mapping;
+            return Attach::attached;
+        }
+
+        void abandon(int fd, const std::string &name, Mapping &head) {
+            if (head.data() != nullptr) { head.header()->state.store(failed, std::memory_order_release); }
+            shm_unlink(name.c_str());
+            close(fd);
+        }
+
+        Publish publish(const std::string &name, int nbClient, const std::string &instNo, bool useBinary,
+            int nbLoadThreads) {
+            int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if (fd < 0) { return errno == EEXIST ? Publish::exists : Publish::failed; }
+            if (ftruncate(fd, imageOffset) != 0) {
+                shm_unlink(name.c_str());
+                close(fd);
+                return Publish::failed;
+            }
+            Mapping head(fd, imageOffset, PROT_READ | PROT_WRITE);
+            if (head.data() == nullptr) {
+                abandon(fd, name, head);
+                return Publish::failed;
+            }
+            head.header()->creator = static_cast<std::int32_t>(getpid());
+
+            // the image stores the raw station info, each process applies its own broken proportion when attaching
+            std::vector<std::byte> image;
+            try {
+                Instance source(nbClient, instNo, 0., false, useBinary, nbLoadThreads);
+                image = BinaryHelper::buildImage(source);
+            } catch (...) {
+                abandon(fd, name, head);
+                throw;
+            }
+            if (image.empty() || ftruncate(fd, static_cast<off_t>(imageOffset + image.size())) != 0) {
+                abandon(fd, name, head);
+                return Publish::failed;
+            }
+            Mapping whole(fd, imageOffset + image.size(), PROT_READ | PROT_WRITE);
+            if (whole.data() == nullptr) {
+                abandon(fd, name, head);
+                return Publish::failed;
+            }
+            std::memcpy(whole.data() + imageOffset, image.data(), image.size());
+            whole.header()->imageSize = image.size();
+            whole.header()->state.store(ready, std::memory_order_release);
+            close(fd);
+            return Publish::published;
+        }
+    } // namespace
+
+    std::string segmentName(int nbClient, const std::string &instNo) {
+        return "/brpwr_v" + std::to_string(BinaryHelper::imageVersion) + "_" + std::to_string(nbClient) + "_" + instNo;
+    }
+
+    bool loadShared(Instance &instance, const std::string &instNo, bool useBinary, int nbLoadThreads) {
+        const std::string name = segmentName(instance.nbClients, instNo);
+        // a segment published before the text files were edited no longer matches them and counts as stale
+        const std::uint64_t fingerprint = BinaryHelper::sourceFingerprint(instance.pathToInstance, instance.nbClients);
+        // a few rounds cover losing the publishing race and replacing a stale segment
+        for (int round = 0; round < 3; round++) {
+            switch (attach(instance, name, fingerprint)) {
+            case Attach::attached:
+                return true;
+            case Attach::unavailable:
+                return false;
+            case Attach::stale:
+                std::cerr << "Shared instance " << name << " is stale, publishing it again" << std::endl;
+                shm_unlink(name.c_str());
+                [[fallthrough]];
+            case Attach::missing:
+                // published or created by another process in the meantime: attach to it in both cases
+                if (publish(name, instance.nbClients, instNo, useBinary, nbLoadThreads) == Publish::failed) {
+                    return false;
+                }
+                break;
+            }
+        }
+        return false;
+    }
+
+    bool unlinkShared(int nbClient, const std::string &instNo) {
+        return shm_unlink(segmentName(nbClient, instNo).c_str()) == 0;
+    }
+} // namespace ShmHelper
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+class Instance;
+
+// Sharing of a loaded instance between solver processes through a named POSIX shared-memory segment. The first
+// process asking for an instance loads it (compiled image or text files) and publishes its compiled image in the
+// segment; it then reads the station tables in place from the read-only mapping like every later process, so the
+// processes solving the same instance on one machine hold a single copy of the tables.
+//
+// Segment layout: SegmentHeader (state, creator pid, image size), then the image (see BinaryHelper) at imageOffset.
+// A segment is stale when its creator died before marking it ready, when its image does not validate (checksum,
+// station count) or when it was built from other versions of the text files of the instance (see
+// BinaryHelper::sourceFingerprint); a stale segment is unlinked and published again. Processes still attached to an
+// unlinked segment keep their mapping, so removing a segment is always safe.
+namespace ShmHelper {
+    // Name of the segment of an instance, it carries the image version so that builds with another image format
+    // never meet, e.g. /brpwr_v2_500_1
+    std::string segmentName(int nbClient, const std::string &instNo);
+
+    // Fills the instance from its shared segment, publishing the segment first if no process did. Returns false
+    // when the instance cannot be shared (no POSIX shared memory, publisher too slow, ...), the caller then loads
+    // the instance on its own.
+    bool loadShared(Instance &instance, const std::string &instNo, bool useBinary, int nbLoadThreads);
+
+    // Removes the segment of an instance, returns false if there was none
+    bool unlinkShared(int nbClient, const std::string &instNo);
+} // namespace ShmHelper
@@ -0,0 +1,45 @@
+#include "ThreadHelper.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ThreadHelper {
+    int resolveThreadCount(int requested) {
+        if (requested > 0) return requested;
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    void parallelFor(int nbTasks, int nbThreads, const std::function<void(int)> &task) {
+        nbThreads = std::min(resolveThreadCount(nbThreads), nbTasks);
+        if (nbThreads <= 1) {
+            for (int i = 0; i < nbTasks; i++) { task(i); }
+            return;
+        }
+
+        std::atomic<int> nextTask{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr firstError;
+        std::mutex errorMutex;
+        auto worker = [&]() {
+            for (int i = nextTask++; i < nbTasks && !failed; i = nextTask++) {
+                try {
+                    task(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!firstError) firstError = std::current_exception();
+                    failed = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(nbThreads - 1);
+        for (int t = 1; t < nbThreads; t++) { threads.emplace_back(worker); }
+        worker();
+        for (auto &thread : threads) { thread.join(); }
+        if (firstError) std::rethrow_exception(firstError);
+    }
+} // namespace ThreadHelper
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <functional>
+
+namespace ThreadHelper {
+    // Number of worker threads to use for a requested count, 0 (or less) meaning one per hardware thread
+    int resolveThreadCount(int requested);
+
+    // Runs task(0) .. task(nbTasks - 1) on up to nbThreads threads (the calling thread included). Tasks are handed
+    // out one at a time, so uneven task sizes balance out. The first exception thrown by a task is rethrown here
+    // once every thread has stopped.
+    void parallelFor(int nbTasks, int nbThreads, const std::function<void(int)> &task);
+} // namespace ThreadHelper
@@ -0,0 +1,93 @@
+#include "UnsatTracker.h"
+
+void UnsatTracker::add(int station, int idx, int surplus, double priority) {
+    if (surplus == 0) { return; }
+    int &entry = slotOf(station);
+    if (entry != -1) {
+        entries[entry].surplus += surplus;
+        entries[entry].priority = priority;
+        siftUp(heapPos[entry]);
+        siftDown(heapPos[entry]);
+        return;
+    }
+    entry = static_cast<int>(entries.size());
+    entries.push_back({station, idx, surplus, priority});
+    heapPos.push_back(static_cast<int>(heap.size()));
+    heap.push_back(entry);
+    siftUp(heap.size() - 1);
+}
+
+void UnsatTracker::overwrite(int station, int idx, int surplus, double priority) {
+    if (surplus == 0) { return; }
+    int entry = slotOf(station);
+    if (entry != -1) {
+        entries[entry].surplus = surplus;
+        entries[entry].priority = priority;
+        siftUp(heapPos[entry]);
+        siftDown(heapPos[entry]);
+        return;
+    }
+    add(station, idx, surplus, priority);
+}
+
+void UnsatTracker::addAll(const UnsatTracker &other) {
+    for (std::size_t entry = 0; entry < other.entries.size(); entry++) {
+        if (other.heapPos[entry] == -1) { continue; }
+        const Entry &station = other.entries[entry];
+        add(station.station, station.idx, station.surplus, station.priority);
+    }
+}
+
+void UnsatTracker::pop() {
+    int removed = heap.front();
+    stationEntry[entries[removed].station] = -1;
+    heapPos[removed] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        place(0, last);
+        siftDown(0);
+    }
+}
+
+void UnsatTracker::clear() {
+    for (const Entry &entry : entries) { stationEntry[entry.station] = -1; }
+    entries.clear();
+    heapPos.clear();
+    heap.clear();
+}
+
+int &UnsatTracker::slotOf(int station) {
+    if (static_cast<std::size_t>(station) >= stationEntry.size()) { stationEntry.resize(station + 1, -1); }
+    return stationEntry[station];
+}
+
+void UnsatTracker::place(std::size_t pos, int entry) {
+    heap[pos] = entry;
+    heapPos[entry] = static_cast<int>(pos);
+}
+
+void UnsatTracker::siftUp(std::size_t pos) {
+    int entry = heap[pos];
+    while (pos > 0) {
+        std::size_t parent = (pos - 1) / 2;
+        if (!before(entry, heap[parent])) { break; }
+        place(pos, heap[parent]);
+        pos = parent;
+    }
+    place(pos, entry);
+}
+
+void UnsatTracker::siftDown(std::size_t pos) {
+    int entry = heap[pos];
+    const std::size_t size = heap.size();
+    while (true) {
+        std::size_t child = 2 * pos + 1;
+        if (child >= size) { break; }
+        if (child + 1 < size && before(heap[child + 1], heap[child])) { child++; }
+        if (!before(heap[child], entry)) { break; }
+        place(pos, heap[child]);
+        pos = child;
+    }
+    place(pos, entry);
+}
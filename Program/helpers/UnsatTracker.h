@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Stations of a truck route whose loading or unloading could not be completed (by lack of time or of vehicle
+// capacity), with the scheme index of their visit, the bikes left and their priority. A station appears at most
+// once: a slot per station gives it in O(1), and an indexed binary heap keeps the stations ordered by decreasing
+// priority, so an update is O(log n) and the station of highest priority is found in O(1). Stations of equal
+// priority come in the order they were added.
+class UnsatTracker {
+public:
+    struct Entry {
+        int station;
+        int idx;
+        int surplus;
+        double priority;
+    };
+
+    // Adds surplus bikes to the station and sets its priority, or adds the station if it is not tracked; a zero
+    // surplus is ignored
+    void add(int station, int idx, int surplus, double priority);
+    // Sets the bikes left at the station and its priority, or adds the station if it is not tracked; a zero
+    // surplus is ignored
+    void overwrite(int station, int idx, int surplus, double priority);
+    // Adds every station of other, in the order they were added to it, as add does
+    void addAll(const UnsatTracker &other);
+
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+    // Station of highest priority, the tracker must not be empty
+    const Entry &top() const { return entries[heap.front()]; }
+    // Sets the bikes left at the station of highest priority
+    void setTopSurplus(int surplus) { entries[heap.front()].surplus = surplus; }
+    // Removes the station of highest priority
+    void pop();
+    void clear();
+
+private:
+    // entry a comes out of the heap before entry b
+    bool before(int a, int b) const {
+        return entries[a].priority > entries[b].priority || (entries[a].priority == entries[b].priority && a < b);
+    }
+    int &slotOf(int station);
+    void place(std::size_t pos, int entry);
+    void siftUp(std::size_t pos);
+    void siftDown(std::size_t pos);
+
+    std::vector<Entry> entries;    // every station added since the last clear, in the order they were added
+    std::vector<int> heapPos;      // position of each entry in heap, -1 once it is removed
+    std::vector<int> heap;         // entries still tracked, as a binary heap
+    std::vector<int> stationEntry; // entry of each station still tracked, -1 otherwise
+};
@@ -3,18 +3,37 @@
 //
 
 #include "Utils.h"
+#include "BuildWorkspace.h"
 #include "Instance.h"
+#include "LoadProfile.h"
 #include "RepInfo.h"
 #include "SortHelper.h"
 #include "TimeHelper.h"
-#include <set>
 
 double getPriority(Instance &instance, const int &station, const int &curUsable, const int &curBroken) {
-    return instance.priorityTable[station - 1][curUsable][curBroken];
+    return instance.priorityTable(station, curUsable, curBroken);
 }
 
 double getPriorityR(Instance &instance, const int &station, const int &curUsable, const int &curBroken) {
-    return instance.priorityTableR[station - 1][curUsable][curBroken];
+    return instance.priorityTableR(station, curUsable, curBroken);
+}
+
+// number of bikes in [0, maxRepair] to repair at a station for the least dissatisfaction, the fewest on a tie
+int getBestRepair(Instance &instance, int station, int curUsable, int curBroken, int maxRepair) {
+    if (curUsable >= 0 && curBroken >= 0 && curUsable + curBroken <= instance.networkInfo[station].capacity) {
+        return instance.bestRepair(station, curUsable, curBroken, maxRepair);
+    }
+    // an inventory outside the table, left by an invalid scheme
+    double minDissatisfaction = instance.dissatTable(station, curUsable, curBroken);
+    int actual = 0;
+    for (int i = 0; i <= maxRepair; i++) {
+        double curDissatisfaction = instance.dissatTable(station, curUsable + i, curBroken - i);
+        if (curDissatisfaction < minDissatisfaction) {
+            minDissatisfaction = curDissatisfaction;
+            actual = i;
+        }
+    }
+    return actual;
 }
 
 /**
@@ -24,12 +43,15 @@ double getPriorityR(Instance &instance, const int &station, const int &curUsable
  * @param curBroken
  * @param route
  * @param isRPM
- * @return
+ * @param maxOperatingTime filled with the maximum operating time of each station
+ * @param priorityVector filled with the priority of each station of the route
  */
-std::pair<std::vector<double>, std::vector<double>> getMaxOpTime(Params &param, const std::vector<int> &curUsable,
-    const std::vector<int> &curBroken, std::vector<int> &route, bool isRPM, Instance &instance) {
+void getMaxOpTime(Params &param, const std::vector<int> &curUsable, const std::vector<int> &curBroken,
+    std::vector<int> &route, bool isRPM, Instance &instance, std::vector<double> &maxOperatingTime,
+    std::vector<double> &priorityVector) {
+    BuildWorkspace &workspace = BuildWorkspace::local();
     double singleOperatingTime = isRPM ? param.repairTime : 2 * param.loadingTime;
-    std::vector<double> priorityVector(instance.networkInfo.size() + 1, 0);
+    priorityVector.assign(instance.networkInfo.size() + 1, 0);
     for (size_t i = 1; i < route.size(); ++i) {
         if (!isRPM)
             priorityVector[route[i]]
@@ -38,9 +60,13 @@ std::pair<std::vector<double>, std::vector<double>> getMaxOpTime(Params &param,
             priorityVector[route[i]]
                 = (route[i] == 0) ? 0 : getPriorityR(instance, route[i], curUsable[route[i]], curBroken[route[i]]);
     }
-    std::vector<StationInfo> stationInfoVector;
-    // make the route a set to remove the duplicate stations
-    std::set<int> routeSet(route.begin(), route.end());
+    std::vector<StationInfo> &stationInfoVector = workspace.stationInfo;
+    stationInfoVector.clear();
+    // sort the stations of the route to remove the duplicate stations
+    std::vector<int> &routeSet = workspace.routeStations;
+    routeSet.assign(route.begin(), route.end());
+    std::sort(routeSet.begin(), routeSet.end());
+    routeSet.erase(std::unique(routeSet.begin(), routeSet.end()), routeSet.end());
     for (auto &node : routeSet) {
         if (node != 0) {
             if (isRPM) {
@@ -83,28 +109,27 @@ std::pair<std::vector<double>, std::vector<double>> getMaxOpTime(Params &param,
             extraTime -= extraTimeToBeAdded;
         }
     }
-    std::vector<double> maxOperatingTime(instance.networkInfo.size(), 0);
+    maxOperatingTime.assign(instance.networkInfo.size(), 0);
 
     for (auto &station : stationInfoVector) { maxOperatingTime[station.stationID] = station.maxOpTime; }
-    std::pair<std::vector<double>, std::vector<double>> maxOpPair = std::make_pair(maxOperatingTime, priorityVector);
-    return maxOpPair;
 }
 
 double routeAdjustment(
     Params &param, std::vector<int> &route, std::vector<double> &priorityVector, bool isRPM, Instance &instance) {
-    // Calculate boundary and factor based on flag
+    // Calculate boundary and travel times based on flag
     double boundary = isRPM ? param.repairTime : 2 * param.loadingTime;
-    double factor = isRPM ? 1.68 : 1.0;
+    const Matrix<double> &travelTime = isRPM ? instance.rpm_dist_mtx : instance.dist_mtx;
 
     // Calculate operating time
     double operatingTime = param.timeBudget;
-    for (size_t i = 1; i < route.size(); ++i) { operatingTime -= instance.dist_mtx[route[i - 1]][route[i]] * factor; }
+    for (size_t i = 1; i < route.size(); ++i) { operatingTime -= travelTime(route[i - 1], route[i]); }
 
     // Early exit if operating time is already above boundary
     if (operatingTime >= boundary) { return operatingTime; }
 
     // Pair station IDs with their priority, excluding the depot (0)
-    std::vector<std::pair<int, double>> stationIDAndPriority;
+    std::vector<std::pair<int, double>> &stationIDAndPriority = BuildWorkspace::local().stationIDAndPriority;
+    stationIDAndPriority.clear();
     for (size_t i = 1; i < route.size(); ++i) {
         if (route[i] != 0) stationIDAndPriority.emplace_back(route[i], priorityVector[route[i]]);
     }
@@ -121,18 +146,18 @@ double routeAdjustment(
 
                 // If we're not removing the first station, add back the cost from the
                 // previous station to this one
-                if (index > 0) { operatingTime += instance.dist_mtx[route[index - 1]][route[index]] * factor; }
+                if (index > 0) { operatingTime += travelTime(route[index - 1], route[index]); }
 
                 // If we're not removing the last station, add back the cost from this
                 // station to the next one
                 if (index < route.size() - 1) {
-                    operatingTime += instance.dist_mtx[route[index]][route[index + 1]] * factor;
+                    operatingTime += travelTime(route[index], route[index + 1]);
                 }
 
                 // If we're removing neither the first nor the last station, subtract
                 // the cost of the direct path from the previous station to the next one
                 if (index > 0 && index < route.size() - 1) {
-                    operatingTime -= instance.dist_mtx[route[index - 1]][route[index + 1]] * factor;
+                    operatingTime -= travelTime(route[index - 1], route[index + 1]);
                 }
 
                 route.erase(it.base() - 1); // Erase the station from the route
@@ -145,16 +170,11 @@ double routeAdjustment(
 }
 
 int adjustDepotLoading(Params &params, const int &demandDeviation, int curStation, std::vector<RSchemeT> &rSchemeVec,
-    int prevDepot, double curStationPriority, double &maxOpTime, UnsatList &unSatUldStationU) {
+    LoadProfile &loads, int prevDepot, double curStationPriority, double &maxOpTime, UnsatList &unSatUldStationU) {
     //  find the smallest residual capacity of the truck from
     //  repositionSchemeVector[prevDepot] to
     //  repositionSchemeVector[repositionSchemeVector.size() - 1]
-    int minResidualCapacity = params.vehicleCapacity - rSchemeVec[prevDepot]->truckUQ - rSchemeVec[prevDepot]->truckBQ;
-
-    for (int i = prevDepot + 1; i < rSchemeVec.size(); i++) {
-        minResidualCapacity
-            = std::min({minResidualCapacity, params.vehicleCapacity - rSchemeVec[i]->truckUQ - rSchemeVec[i]->truckBQ});
-    }
+    int minResidualCapacity = loads.minResidual(prevDepot, rSchemeVec.size());
 
     // calculate fd with the following strategies:
     // if prev depot loadingU > 0 and prev depot unloadingU == 0, fd =
@@ -166,10 +186,10 @@ int adjustDepotLoading(Params &params, const int &demandDeviation, int curStatio
     // allowed at each station
     int fd;
 
-    if (rSchemeVec[prevDepot]->loadingQuantityU > 0 && rSchemeVec[prevDepot]->unloadingQuantityU == 0) {
-        fd = rSchemeVec[prevDepot]->loadingQuantityU;
-    } else if (rSchemeVec[prevDepot]->loadingQuantityU == 0 && rSchemeVec[prevDepot]->unloadingQuantityU > 0) {
-        fd = -rSchemeVec[prevDepot]->unloadingQuantityU;
+    if (rSchemeVec[prevDepot].loadingQuantityU > 0 && rSchemeVec[prevDepot].unloadingQuantityU == 0) {
+        fd = rSchemeVec[prevDepot].loadingQuantityU;
+    } else if (rSchemeVec[prevDepot].loadingQuantityU == 0 && rSchemeVec[prevDepot].unloadingQuantityU > 0) {
+        fd = -rSchemeVec[prevDepot].unloadingQuantityU;
     } else {
         fd = 0;
     }
@@ -184,30 +204,24 @@ int adjustDepotLoading(Params &params, const int &demandDeviation, int curStatio
     int ep = std::min(epNoTime, epByTime);
     if (fd + ep > 0) {
         // last depot final loading decision is loading usable bikes
-        rSchemeVec[prevDepot]->loadingQuantityU = fd + ep;
-        rSchemeVec[prevDepot]->unloadingQuantityU = 0;
+        rSchemeVec[prevDepot].loadingQuantityU = fd + ep;
+        rSchemeVec[prevDepot].unloadingQuantityU = 0;
         maxOpTime -= 2 * (std::min(fd, 0) + ep) * params.loadingTime;
     } else {
         // last depot final loading decision is unloading usable bikes
-        rSchemeVec[prevDepot]->loadingQuantityU = 0;
-        rSchemeVec[prevDepot]->unloadingQuantityU = -fd - ep;
-    }
-    rSchemeVec[prevDepot]->truckUQ += ep;
-    // update the truckUsable and truckBroken in the repoSchemeVector one by one
-    // from prevDepot to the end
-    for (int i = prevDepot + 1; i < rSchemeVec.size(); i++) {
-        rSchemeVec[i]->truckUQ
-            = rSchemeVec[i - 1]->truckUQ + rSchemeVec[i]->loadingQuantityU - rSchemeVec[i]->unloadingQuantityU;
-        rSchemeVec[i]->truckBQ
-            = rSchemeVec[i - 1]->truckBQ + rSchemeVec[i]->loadingQuantityB - rSchemeVec[i]->unloadingQuantityB;
+        rSchemeVec[prevDepot].loadingQuantityU = 0;
+        rSchemeVec[prevDepot].unloadingQuantityU = -fd - ep;
     }
+    // the ep bikes loaded at prevDepot stay on board up to the current station
+    loads.addUsable(prevDepot, rSchemeVec.size(), ep);
     return ep;
 }
 
 std::pair<int, int> assignUnloadingQuantities(std::vector<int> &curUsable, std::vector<int> &curBroken,
     std::vector<double> &maxOpTime, int &curStation, int &truckUsable, int &truckBroken, Params &params,
-    std::vector<RSchemeT> &rSchemeVec, int &prevDepot, UnsatList &unSatLdStationU, UnsatList &unSatLdStationB,
-    UnsatList &unSatUldStationU, std::vector<std::pair<int, double>> &uldExtraTime, Instance &instance) {
+    std::vector<RSchemeT> &rSchemeVec, LoadProfile &loads, int &prevDepot, UnsatList &unSatLdStationU,
+    UnsatList &unSatLdStationB, UnsatList &unSatUldStationU, std::vector<std::pair<int, double>> &uldExtraTime,
+    Instance &instance) {
     int brokenLoad = 0;
     int stationResidualCapacity
         = instance.networkInfo[curStation].capacity - curUsable[curStation] - curBroken[curStation];
@@ -219,7 +233,7 @@ std::pair<int, int> assignUnloadingQuantities(std::vector<int> &curUsable, std::
             = instance.networkInfo[curStation].capacity - curUsable[curStation] - curBroken[curStation];
     }
     int usableUnload = unloadUsable(curStation, prevDepot, unSatLdStationU, unSatUldStationU, uldExtraTime,
-        stationResidualCapacity, curUsable, curBroken, maxOpTime, truckUsable, params, rSchemeVec, instance);
+        stationResidualCapacity, curUsable, curBroken, maxOpTime, truckUsable, params, rSchemeVec, loads, instance);
 
     if (maxOpTime[curStation] >= 2 * params.loadingTime) {
         suppLoadBroken(curUsable, curBroken, maxOpTime, curStation, truckUsable, truckBroken, params, rSchemeVec,
@@ -241,14 +255,13 @@ void suppLoadBroken(const std::vector<int> &curUsable, std::vector<int> &curBrok
     truckBroken += newBrokenLoad;
     curBroken[curStation] -= newBrokenLoad;
     unSatUpdateOverwrite(unSatLdStationB, curStation, rSchemeVec.size(),
-        std::max(newBrokenLoadNoTime - newBrokenLoadByTime, 0),
-        getPriority(instance, curStation, curUsable[curStation], curBroken[curStation]));
+        std::max(newBrokenLoadNoTime - newBrokenLoadByTime, 0), curUsable, curBroken, instance);
 }
 
 int unloadUsable(const int &curStation, const int &prevDepot, UnsatList &unSatLdStationU, UnsatList &unSatUldStationU,
     std::vector<std::pair<int, double>> &uldExtraTime, int stationResidualCapacity, std::vector<int> &curUsable,
     std::vector<int> &curBroken, std::vector<double> &maxOpTime, int &truckUsable, Params &params,
-    std::vector<RSchemeT> &rSchemeVec, Instance &instance) {
+    std::vector<RSchemeT> &rSchemeVec, LoadProfile &loads, Instance &instance) {
     int usableUnload = 0;
     int supplyDemand
         = std::min({instance.networkInfo[curStation].targetUsable - curUsable[curStation], stationResidualCapacity});
@@ -263,36 +276,31 @@ int unloadUsable(const int &curStation, const int &prevDepot, UnsatList &unSatLd
         // station, so we need to load more bikes at the previous nodes if possible.
         // We first check those non-depot previous visited loading nodes whose
         // surplus bikes were not fully loaded due to insufficient maxoptime, which
-        // are stored in unSatLdStation.
-        Sort::sortBy<3>(unSatLdStationU, false);
+        // are stored in unSatLdStation, by decreasing priority.
         while (usableUnload != supplyDemand && !unSatLdStationU.empty()
                && maxOpTime[curStation] >= 2 * params.loadingTime) {
-            auto [station, idx, surplus, priority] = unSatLdStationU[0];
+            auto [station, idx, surplus, priority] = unSatLdStationU.top();
 
-            int minimumResidual = params.vehicleCapacity - rSchemeVec[idx]->truckUQ - rSchemeVec[idx]->truckBQ;
             // find out the minimum residual capacity of the truck from
             // rSchemeVec[idx] to rSchemeVec[rSchemeVec.size() - 1]
-            for (int i = idx + 1; i < rSchemeVec.size(); i++) {
-                minimumResidual = std::min(
-                    {minimumResidual, params.vehicleCapacity - rSchemeVec[i]->truckUQ - rSchemeVec[i]->truckBQ});
-            }
+            int minimumResidual = loads.minResidual(idx, rSchemeVec.size());
             if (minimumResidual == 0) { break; }
             int addedLoadNoTime = std::min({supplyDemand - usableUnload, minimumResidual, surplus});
             int addedLoadByTime = TimeHelper::maxLoadQByTime(params, maxOpTime[curStation]);
             int addedLoad = std::min(addedLoadNoTime, addedLoadByTime);
-            rSchemeVec[idx]->loadingQuantityU += addedLoad;
+            rSchemeVec[idx].loadingQuantityU += addedLoad;
             curUsable[station] -= addedLoad;
             unSatUpdateOverwrite(unSatUldStationU, curStation, rSchemeVec.size(), addedLoadNoTime - addedLoad,
-                getPriority(instance, curStation, curUsable[curStation], curBroken[curStation]));
-            for (int i = idx; i < rSchemeVec.size(); i++) { rSchemeVec[i]->truckUQ += addedLoad; }
+                curUsable, curBroken, instance);
+            loads.addUsable(idx, rSchemeVec.size(), addedLoad);
             curUsable[curStation] += addedLoad;
             usableUnload += addedLoad;
             surplus -= addedLoad;
 
             if (surplus == 0) {
-                unSatLdStationU.erase(unSatLdStationU.begin());
+                unSatLdStationU.pop();
             } else {
-                std::get<2>(unSatLdStationU[0]) = surplus;
+                unSatLdStationU.setTopSurplus(surplus);
             }
             maxOpTime[curStation] -= 2 * addedLoad * params.loadingTime;
         }
@@ -300,14 +308,14 @@ int unloadUsable(const int &curStation, const int &prevDepot, UnsatList &unSatLd
         if (usableUnload != supplyDemand) {
             // if the usableUnload is still not enough, we need to load more bikes at
             // the depot
-            int ep = adjustDepotLoading(params, supplyDemand - usableUnload, curStation, rSchemeVec, prevDepot,
+            int ep = adjustDepotLoading(params, supplyDemand - usableUnload, curStation, rSchemeVec, loads, prevDepot,
                 getPriority(instance, curStation, curUsable[curStation], curBroken[curStation]), maxOpTime[curStation],
                 unSatUldStationU);
             usableUnload += ep;
             curUsable[curStation] += ep;
         }
     }
-    truckUsable = rSchemeVec[rSchemeVec.size() - 1]->truckUQ - usableUnload;
+    truckUsable = loads.usable(rSchemeVec.size() - 1) - usableUnload;
     return usableUnload;
 }
 
@@ -324,8 +332,8 @@ int loadBroken(const int &curStation, const int &truckUsable, const int &idx, st
         curBroken[curStation] -= brokenLoad;
         truckBroken += brokenLoad;
         maxOpTime[curStation] -= 2 * brokenLoad * params.loadingTime;
-        unSatUpdateOverwrite(unSatLdStationB, curStation, idx, brokenLoadNoTime - brokenLoad,
-            getPriority(instance, curStation, curUsable[curStation], curBroken[curStation]));
+        unSatUpdateOverwrite(
+            unSatLdStationB, curStation, idx, brokenLoadNoTime - brokenLoad, curUsable, curBroken, instance);
     }
     return brokenLoad;
 }
@@ -356,26 +364,37 @@ int loadUsable(const int &curStation, const int &schemeIdx, const int &truckBrok
     curUsable[curStation] -= usableLoad;
     truckUsable += usableLoad;
     unSatUpdateOverwrite(unSatLdStationU, curStation, schemeIdx, std::max(usableLoadNoTime - usableLoadByTime, 0),
-        getPriority(instance, curStation, curUsable[curStation], curBroken[curStation]));
+        curUsable, curBroken, instance);
     return usableLoad;
 }
 
-std::vector<RSchemeT> assignTruckScheme(Params &param, std::vector<int> &route, std::vector<int> &curUsable,
-    std::vector<int> &curBroken, Instance &instance) {
-    std::vector<RSchemeT> rSchemeVec;
-    auto [maxOpTime, priority] = getMaxOpTime(param, curUsable, curBroken, route, false, instance);
+void assignTruckScheme(Params &param, std::vector<int> &route, std::vector<int> &curUsable,
+    std::vector<int> &curBroken, Instance &instance, std::vector<RSchemeT> &rSchemeVec) {
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    std::vector<double> &maxOpTime = workspace.maxOpTime;
+    getMaxOpTime(param, curUsable, curBroken, route, false, instance, maxOpTime, workspace.priority);
     int prevDepot = 0, truckUsable = 0, truckBroken = 0;
-    UnsatList unSatLdStationU;
-    UnsatList unSatLdStationB;
-    UnsatList unSatUldStationU;
-    std::vector<std::pair<int, double>> uldExtraTime;
-
-    std::vector<int> curUsableBackup = curUsable;
-    std::vector<int> curBrokenBackup = curBroken;
-    std::vector<double> maxOpTimeBackup = maxOpTime;
-
-    rSchemeVec = greedyAssignment(param, route, curUsable, curBroken, maxOpTime, prevDepot, truckUsable, truckBroken,
-        unSatLdStationU, unSatLdStationB, unSatUldStationU, uldExtraTime, instance);
+    UnsatList &unSatLdStationU = workspace.unSatLdStationU;
+    UnsatList &unSatLdStationB = workspace.unSatLdStationB;
+    UnsatList &unSatUldStationU = workspace.unSatUldStationU;
+    std::vector<std::pair<int, double>> &uldExtraTime = workspace.uldExtraTime;
+    unSatLdStationU.clear();
+    unSatLdStationB.clear();
+    unSatUldStationU.clear();
+    uldExtraTime.clear();
+
+    std::vector<int> &curUsableBackup = workspace.usableBackup;
+    std::vector<int> &curBrokenBackup = workspace.brokenBackup;
+    std::vector<double> &maxOpTimeBackup = workspace.maxOpTimeBackup;
+    curUsableBackup = curUsable;
+    curBrokenBackup = curBroken;
+    maxOpTimeBackup = maxOpTime;
+
+    greedyAssignment(param, route, curUsable, curBroken, maxOpTime, prevDepot, truckUsable, truckBroken,
+        unSatLdStationU, unSatLdStationB, unSatUldStationU, uldExtraTime, instance, rSchemeVec);
+    // in a single pass the time left by the unloading stations is not handed
+    // to the unsatisfied stations, truckSchemeAmendment spends it later
+    if (param.ap.singlePassAssignment) { return; }
 
     maxOpTime = maxOpTimeBackup;
     // We subtract maxoptime for the items in uldExtraTime from the maxOpTime of
@@ -392,28 +411,20 @@ std::vector<RSchemeT> assignTruckScheme(Params &param, std::vector<int> &route,
         maxOpTime[idx.first] -= modifiedTime;
     }
 
-    // combine the unSatLdStationU and unSatLdStationB and sort them by priority
+    // combine the unSatLdStationU and unSatLdStationB, ordered by priority
     // (if some node appears in both unSatLdStationU and unSatLdStationB, we only
     // keep the priority of the one in unSatLdStationB)
-
-    for (auto &idx : unSatUldStationU) {
-        unSatUpdate(unSatLdStationU, std::get<0>(idx), std::get<1>(idx), std::get<2>(idx), std::get<3>(idx));
-    }
-
-    for (auto &idx : unSatLdStationB) {
-        unSatUpdate(unSatLdStationU, std::get<0>(idx), std::get<1>(idx), std::get<2>(idx), std::get<3>(idx));
-    }
-
-    UnsatList unSatLdStation = unSatLdStationU;
+    unSatLdStationU.addAll(unSatUldStationU);
+    unSatLdStationU.addAll(unSatLdStationB);
 
     if (extraTime > 0) {
-        Sort::sortBy<3>(unSatLdStation, false);
+        UnsatList &unSatLdStation = unSatLdStationU;
         while (extraTime > 0 && !unSatLdStation.empty()) {
-            auto [station, idx, surplus, priority] = unSatLdStation[0];
+            auto [station, idx, surplus, priority] = unSatLdStation.top();
             int adjustedLoadingTime = std::min({surplus * 2.0 * param.loadingTime, extraTime});
             maxOpTime[station] += adjustedLoadingTime;
             extraTime -= adjustedLoadingTime;
-            unSatLdStation.erase(unSatLdStation.begin());
+            unSatLdStation.pop();
         }
 
         curUsable = curUsableBackup, curBroken = curBrokenBackup;
@@ -422,117 +433,191 @@ std::vector<RSchemeT> assignTruckScheme(Params &param, std::vector<int> &route,
         unSatLdStationB.clear();
         unSatUldStationU.clear();
         uldExtraTime.clear();
-        rSchemeVec = greedyAssignment(param, route, curUsable, curBroken, maxOpTime, prevDepot, truckUsable,
-            truckBroken, unSatLdStationU, unSatLdStationB, unSatUldStationU, uldExtraTime, instance);
+        greedyAssignment(param, route, curUsable, curBroken, maxOpTime, prevDepot, truckUsable, truckBroken,
+            unSatLdStationU, unSatLdStationB, unSatUldStationU, uldExtraTime, instance, rSchemeVec);
     }
-
-    return rSchemeVec;
 }
 
-std::vector<RSchemeR> assignRepairmanScheme(Params &params, std::vector<int> &route, std::vector<int> &curUsable,
-    std::vector<int> &curBroken, Instance &instance) {
+void assignRepairmanScheme(Params &params, std::vector<int> &route, std::vector<int> &curUsable,
+    std::vector<int> &curBroken, Instance &instance, std::vector<RSchemeR> &rSchemeVec) {
+    if (params.ap.optimalRepairTime) {
+        allocateRepairTime(params, route, curUsable, curBroken, instance, rSchemeVec);
+        return;
+    }
     // We set a maximum operating time for each element in the route based on the
     // priority of the stations (use proportional distribution)
-    auto [maxOpTime, priority] = getMaxOpTime(params, curUsable, curBroken, route, true, instance);
-    std::vector<RSchemeR> rSchemeVec;
-    rSchemeVec.push_back(std::make_shared<RepositionSchemeRPM>());
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    std::vector<double> &maxOpTime = workspace.maxOpTime;
+    getMaxOpTime(params, curUsable, curBroken, route, true, instance, maxOpTime, workspace.priority);
+    rSchemeVec.clear();
+    rSchemeVec.reserve(route.size());
+    rSchemeVec.emplace_back();
     double extraTime = 0;
     for (int i = 1; i < route.size(); i++) {
-        RSchemeR rScheme = std::make_shared<RepositionSchemeRPM>();
+        RSchemeR rScheme;
         int curStation = route[i];
-        rScheme->station = curStation;
+        rScheme.station = curStation;
         if (curStation != 0) {
             int supplyDemand = std::max(instance.networkInfo[curStation].targetUsable - curUsable[curStation], 0);
             int repairQuantity = std::min(
                 {supplyDemand, TimeHelper::maxRepairQByTime(params, maxOpTime[curStation]), curBroken[curStation]});
             maxOpTime[curStation] -= repairQuantity * params.repairTime;
-            rScheme->repairingQuantity = repairQuantity;
+            rScheme.repairingQuantity = repairQuantity;
             curUsable[curStation] += repairQuantity;
             curBroken[curStation] -= repairQuantity;
             extraTime += maxOpTime[curStation];
         }
         rSchemeVec.push_back(rScheme);
     }
-    std::vector<std::pair<int, double>> routeByPriority;
-    // create a vector of the route sorted by priority read from the priority
-    // vector (priority[route[i]])
-    for (int i = 0; i < route.size(); i++) {
-        if (route[i] != 0)
-            routeByPriority.emplace_back(
-                route[i], getPriorityR(instance, route[i], curUsable[route[i]], curBroken[route[i]]));
+}
+
+// The repair time left by the travel of the route is a knapsack: each station
+// of the route repairs k of its broken bikes, for a gain of its dissatisfaction
+// at (usable, broken) minus the one at (usable + k, broken - k), and the counts
+// of the largest total gain within the time budget are found by a dynamic
+// program over the number of repairs. A station visited twice is repaired at
+// its first visit.
+void allocateRepairTime(Params &params, std::vector<int> &route, std::vector<int> &curUsable,
+    std::vector<int> &curBroken, Instance &instance, std::vector<RSchemeR> &rSchemeVec) {
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    double repairBudget = params.timeBudget;
+    for (int i = 1; i < route.size(); i++) { repairBudget -= instance.rpm_dist_mtx(route[i - 1], route[i]); }
+    int maxRepairs = repairBudget > 0 ? TimeHelper::maxRepairQByTime(params, repairBudget) : 0;
+
+    // the stops that can repair, with the gain curve of their station for
+    // k = 0..cap repairs, stored one after the other
+    std::vector<int> &stops = workspace.repairStops;
+    std::vector<int> &curveStart = workspace.gainCurveStart;
+    std::vector<double> &gain = workspace.repairGain;
+    stops.clear();
+    curveStart.assign(1, 0);
+    gain.clear();
+    int totalRepairs = 0;
+    for (int i = 1; i < route.size() && maxRepairs > 0; i++) {
+        int station = route[i];
+        int usable = curUsable[station], broken = curBroken[station];
+        if (station == 0 || broken <= 0 || usable < 0 || usable + broken > instance.networkInfo[station].capacity
+            || std::find(route.begin() + 1, route.begin() + i, station) != route.begin() + i) {
+            continue;
+        }
+        int cap = std::min(broken, maxRepairs);
+        double dissatisfaction = instance.dissatTable(station, usable, broken);
+        for (int k = 0; k <= cap; k++) {
+            gain.push_back(dissatisfaction - instance.dissatTable(station, usable + k, broken - k));
+        }
+        stops.push_back(i);
+        curveStart.push_back(static_cast<int>(gain.size()));
+        totalRepairs += cap;
     }
-    Sort::sortBy(routeByPriority, &std::pair<int, double>::second, false);
 
-    return rSchemeVec;
+    // bestGain[r] is the largest gain of the stops so far with at most r
+    // repairs, repairs[j * (budget + 1) + r] the count of stop j in it
+    int budget = std::min(maxRepairs, totalRepairs);
+    std::vector<double> &bestGain = workspace.bestGain;
+    std::vector<double> &nextGain = workspace.nextGain;
+    std::vector<int> &repairs = workspace.repairChoice;
+    bestGain.assign(budget + 1, 0.);
+    nextGain.resize(budget + 1);
+    repairs.resize(stops.size() * (budget + 1));
+    for (std::size_t j = 0; j < stops.size(); j++) {
+        const double *curve = gain.data() + curveStart[j];
+        int cap = curveStart[j + 1] - curveStart[j] - 1;
+        int *choice = repairs.data() + j * (budget + 1);
+        for (int r = 0; r <= budget; r++) {
+            // the fewest repairs on a tie
+            double best = bestGain[r];
+            int count = 0;
+            for (int k = 1; k <= std::min(cap, r); k++) {
+                double withK = bestGain[r - k] + curve[k];
+                if (withK > best) {
+                    best = withK;
+                    count = k;
+                }
+            }
+            nextGain[r] = best;
+            choice[r] = count;
+        }
+        std::swap(bestGain, nextGain);
+    }
+
+    rSchemeVec.assign(route.size(), RSchemeR());
+    for (int i = 1; i < route.size(); i++) { rSchemeVec[i].station = route[i]; }
+    for (int j = static_cast<int>(stops.size()) - 1, r = budget; j >= 0; j--) {
+        int count = repairs[j * (budget + 1) + r];
+        int station = route[stops[j]];
+        rSchemeVec[stops[j]].repairingQuantity = count;
+        curUsable[station] += count;
+        curBroken[station] -= count;
+        r -= count;
+    }
 }
 
-std::vector<RSchemeT> greedyAssignment(Params &param, std::vector<int> &route, std::vector<int> &curUsable,
+void greedyAssignment(Params &param, std::vector<int> &route, std::vector<int> &curUsable,
     std::vector<int> &curBroken, std::vector<double> &maxOpTime, int &prevDepot, int &truckUsable, int &truckBroken,
     UnsatList &unsatLdStationU, UnsatList &unsatLdStationB, UnsatList &unSatUldStationU,
-    std::vector<std::pair<int, double>> &idxExtraTime, Instance &instance) {
-    std::vector<RSchemeT> rSchemeVec;
+    std::vector<std::pair<int, double>> &idxExtraTime, Instance &instance, std::vector<RSchemeT> &rSchemeVec) {
+    rSchemeVec.clear();
+    rSchemeVec.reserve(route.size());
+    // the loads of the truck are kept in the profile while the quantities are
+    // assigned, and written to the scheme at the end
+    LoadProfile &loads = BuildWorkspace::local().truckLoads;
+    loads.reset(param.vehicleCapacity, route.size(), LoadProfile::longestSpan(route));
     int i = 0;
     for (auto &curStation : route) {
-        RSchemeT rScheme = std::make_shared<RepositionSchemeTRK>();
-        rScheme->station = curStation;
+        RSchemeT rScheme;
+        rScheme.station = curStation;
         if (curStation != 0) {
             if (curUsable[curStation] <= instance.networkInfo[curStation].targetUsable) {
                 auto [usableUnload, brokenLoad] = assignUnloadingQuantities(curUsable, curBroken, maxOpTime, curStation,
-                    truckUsable, truckBroken, param, rSchemeVec, prevDepot, unsatLdStationU, unsatLdStationB,
+                    truckUsable, truckBroken, param, rSchemeVec, loads, prevDepot, unsatLdStationU, unsatLdStationB,
                     unSatUldStationU, idxExtraTime, instance);
-                rScheme->unloadingQuantityU = usableUnload;
-                rScheme->loadingQuantityB = brokenLoad;
+                rScheme.unloadingQuantityU = usableUnload;
+                rScheme.loadingQuantityB = brokenLoad;
             } else {
                 auto [usableLoad, brokenLoad] = assignLoadingQuantities(curUsable, curBroken, maxOpTime, curStation, i,
                     truckUsable, truckBroken, param, unsatLdStationU, unsatLdStationB, instance);
-                rScheme->loadingQuantityU = usableLoad;
-                rScheme->loadingQuantityB = brokenLoad;
+                rScheme.loadingQuantityU = usableLoad;
+                rScheme.loadingQuantityB = brokenLoad;
             }
         } else {
-            rScheme->loadingQuantityU = 0;
-            rScheme->loadingQuantityB = 0;
-            rScheme->unloadingQuantityU = truckUsable;
-            rScheme->unloadingQuantityB = truckBroken;
+            rScheme.loadingQuantityU = 0;
+            rScheme.loadingQuantityB = 0;
+            rScheme.unloadingQuantityU = truckUsable;
+            rScheme.unloadingQuantityB = truckBroken;
             prevDepot = i;
             truckUsable = 0;
             truckBroken = 0;
         }
-        rScheme->truckUQ = truckUsable;
-        rScheme->truckBQ = truckBroken;
+        rScheme.truckUQ = truckUsable;
+        rScheme.truckBQ = truckBroken;
         rSchemeVec.push_back(rScheme);
+        loads.push(truckUsable, truckBroken);
         i++;
     }
-
-    return rSchemeVec;
+    loads.writeTo(rSchemeVec);
 }
 
 void unSatUpdate(
     UnsatList &unSatStation, const int &curStation, const int &idx, const int &surplus, const double &priority) {
-    if (surplus == 0) { return; }
-    auto it = std::find_if(unSatStation.begin(), unSatStation.end(),
-        [curStation](const auto &station) { return std::get<0>(station) == curStation; });
-    if (it != unSatStation.end()) {
-        std::get<2>(*it) += surplus;
-        std::get<3>(*it) = priority;
-    } else {
-        unSatStation.emplace_back(curStation, idx, surplus, priority);
-    }
+    unSatStation.add(curStation, idx, surplus, priority);
 }
 
 void repairmanSchemeAmendment(Params &params, std::vector<RSchemeR> &rSchemeVec, std::vector<int> &curUsable,
-    std::vector<int> &curBroken, std::unordered_set<int> &trkStationSet, Instance &instance) {
+    std::vector<int> &curBroken, const std::vector<bool> &inRoutes, Instance &instance) {
+    BuildWorkspace &workspace = BuildWorkspace::local();
     // total time spent by the repairman
     double totalRouteAndRepairTime = 0;
-    std::vector<std::pair<int, double>> stationAndPriority;
+    std::vector<std::pair<int, double>> &stationAndPriority = workspace.repairPriority;
+    stationAndPriority.clear();
     for (int i = 1; i < rSchemeVec.size(); i++) {
-        int cStd = rSchemeVec[i]->station;
-        totalRouteAndRepairTime += instance.dist_mtx[rSchemeVec[i - 1]->station][cStd] * 1.68;
-        totalRouteAndRepairTime += rSchemeVec[i]->repairingQuantity * params.repairTime;
+        int cStd = rSchemeVec[i].station;
+        totalRouteAndRepairTime += instance.rpm_dist_mtx(rSchemeVec[i - 1].station, cStd);
+        totalRouteAndRepairTime += rSchemeVec[i].repairingQuantity * params.repairTime;
         if (cStd != 0 && curBroken[cStd] > 0) {
-            double priorityA = instance.dissatTable[cStd][curUsable[cStd]][curBroken[cStd]]
-                               - instance.dissatTable[cStd][curUsable[cStd] + 1][curBroken[cStd] - 1];
+            double priorityA = instance.dissatTable(cStd, curUsable[cStd], curBroken[cStd])
+                               - instance.dissatTable(cStd, curUsable[cStd] + 1, curBroken[cStd] - 1);
 
-            if (priorityA > 0) stationAndPriority.emplace_back(rSchemeVec[i]->station, priorityA);
+            if (priorityA > 0) stationAndPriority.emplace_back(rSchemeVec[i].station, priorityA);
         }
     }
     Sort::sortBy(stationAndPriority, &std::pair<int, double>::second, false);
@@ -540,20 +625,11 @@ void repairmanSchemeAmendment(Params &params, std::vector<RSchemeR> &rSchemeVec,
     while (extraTime > 0 && !stationAndPriority.empty()) {
         auto [curStation, priority] = stationAndPriority[0];
         auto it = std::find_if(rSchemeVec.begin() + 1, rSchemeVec.end(),
-            [curStation](const auto &scheme) { return scheme->station == curStation; });
+            [curStation](const auto &scheme) { return scheme.station == curStation; });
         if (it != rSchemeVec.end()) {
             int maxrepair = std::min(curBroken[curStation], TimeHelper::maxRepairQByTime(params, extraTime));
-            double minDissatisfaction = instance.dissatTable[curStation][curUsable[curStation]][curBroken[curStation]];
-            int actual = 0;
-            for (int i = 0; i <= maxrepair; i++) {
-                double curDissatisfaction
-                    = instance.dissatTable[curStation][curUsable[curStation] + i][curBroken[curStation] - i];
-                if (curDissatisfaction < minDissatisfaction) {
-                    minDissatisfaction = curDissatisfaction;
-                    actual = i;
-                }
-            }
-            (*it)->repairingQuantity += actual;
+            int actual = getBestRepair(instance, curStation, curUsable[curStation], curBroken[curStation], maxrepair);
+            it->repairingQuantity += actual;
             curUsable[curStation] += actual;
             curBroken[curStation] -= actual;
             extraTime -= actual * params.repairTime;
@@ -572,14 +648,37 @@ void repairmanSchemeAmendment(Params &params, std::vector<RSchemeR> &rSchemeVec,
 
     // firstly we gather the stations that are able to repair but not in the
     // route, with their priority
-    std::vector<std::pair<int, double>> repairableStation;
-    for (int i = 1; i < instance.networkInfo.size(); i++) {
-        if (curBroken[i] > 0 && trkStationSet.find(i) == trkStationSet.end()) {
+    std::vector<std::pair<int, double>> &repairableStation = workspace.repairableStation;
+    repairableStation.clear();
+    // with the neighbor lists, only the stations close to a stop of the route
+    // are candidates
+    std::vector<int> &candidates = workspace.insertionCandidates;
+    candidates.clear();
+    if (instance.nbNeighbors() > 0) {
+        std::vector<char> &isCandidate = workspace.isInsertionCandidate;
+        isCandidate.assign(instance.networkInfo.size(), 0);
+        for (const auto &stop : rSchemeVec) {
+            for (int r = 0; r < instance.nbNeighbors(); r++) {
+                for (int station : {instance.nearestSuccessors(stop.station, r),
+                         instance.nearestPredecessors(stop.station, r)}) {
+                    if (!isCandidate[station]) {
+                        isCandidate[station] = 1;
+                        candidates.push_back(station);
+                    }
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+    } else {
+        for (int i = 1; i < instance.networkInfo.size(); i++) { candidates.push_back(i); }
+    }
+    for (int i : candidates) {
+        if (curBroken[i] > 0 && !inRoutes[i]) {
             // here priority is defined as the reduction in the dissatisfaction after
             // 1 bike repair, negative priority means that the station is not able to
             // repair, we set the priority to 0
-            double priority = instance.dissatTable[i][curUsable[i]][curBroken[i]]
-                              - instance.dissatTable[i][curUsable[i] + 1][curBroken[i] - 1];
+            double priority = instance.dissatTable(i, curUsable[i], curBroken[i])
+                              - instance.dissatTable(i, curUsable[i] + 1, curBroken[i] - 1);
             // std::cout << "~~~~station " << i << " has priority " << priority <<
             // std::endl;
             if (priority > 0) repairableStation.emplace_back(i, priority);
@@ -590,16 +689,17 @@ void repairmanSchemeAmendment(Params &params, std::vector<RSchemeR> &rSchemeVec,
     while (extraTime > params.repairTime && !repairableStation.empty()) {
         auto [chosenStation, priority] = repairableStation[0];
         // std::cout << "inserting station " << chosenStation << std::endl;
-        double minimumInsertionTime = (instance.dist_mtx[rSchemeVec[0]->station][chosenStation]
-                                          + instance.dist_mtx[chosenStation][rSchemeVec[1]->station]
-                                          - instance.dist_mtx[rSchemeVec[0]->station][rSchemeVec[1]->station])
-                                      * 1.68;
+        // the detour is scaled once, as scaling each leg first rounds differently
+        double minimumInsertionTime = (instance.dist_mtx(rSchemeVec[0].station, chosenStation)
+                                          + instance.dist_mtx(chosenStation, rSchemeVec[1].station)
+                                          - instance.dist_mtx(rSchemeVec[0].station, rSchemeVec[1].station))
+                                      * instance.repairmanSpeedFactor;
         int insertIdx = 1;
         for (int i = 1; i < rSchemeVec.size(); i++) {
-            double insertionTime = (instance.dist_mtx[rSchemeVec[i - 1]->station][chosenStation]
-                                       + instance.dist_mtx[chosenStation][rSchemeVec[i]->station]
-                                       - instance.dist_mtx[rSchemeVec[i - 1]->station][rSchemeVec[i]->station])
-                                   * 1.68;
+            double insertionTime = (instance.dist_mtx(rSchemeVec[i - 1].station, chosenStation)
+                                       + instance.dist_mtx(chosenStation, rSchemeVec[i].station)
+                                       - instance.dist_mtx(rSchemeVec[i - 1].station, rSchemeVec[i].station))
+                                   * instance.repairmanSpeedFactor;
             if (insertionTime < minimumInsertionTime) {
                 minimumInsertionTime = insertionTime;
                 insertIdx = i;
@@ -608,28 +708,18 @@ void repairmanSchemeAmendment(Params &params, std::vector<RSchemeR> &rSchemeVec,
         // std::cout << "insertion time " << minimumInsertionTime << std::endl;
         if (extraTime - minimumInsertionTime > params.repairTime) {
             // we insert the station into the route
-            RSchemeR rScheme = std::make_shared<RepositionSchemeRPM>();
-            rScheme->station = chosenStation;
-            rScheme->repairingQuantity = 0;
+            RSchemeR rScheme;
+            rScheme.station = chosenStation;
+            rScheme.repairingQuantity = 0;
             rSchemeVec.insert(rSchemeVec.begin() + insertIdx, rScheme);
             extraTime -= minimumInsertionTime;
             // we do the repair at the station
             int maxrepair = std::min(curBroken[chosenStation], TimeHelper::maxRepairQByTime(params, extraTime));
-            // std::cout << "max repair at station " << chosenStation << " is " <<
-            // maxrepair << std::endl; try repair from 0 to maxrepair, find the one
-            // that generates the lowest user dissatisfaction at the station
-            double minDissatisfaction
-                = instance.dissatTable[chosenStation][curUsable[chosenStation]][curBroken[chosenStation]];
-            int actual = 0;
-            for (int i = 0; i <= maxrepair; i++) {
-                double curDissatisfaction
-                    = instance.dissatTable[chosenStation][curUsable[chosenStation] + i][curBroken[chosenStation] - i];
-                if (curDissatisfaction < minDissatisfaction) {
-                    minDissatisfaction = curDissatisfaction;
-                    actual = i;
-                }
-            }
-            rSchemeVec[insertIdx]->repairingQuantity += actual;
+            // the repair from 0 to maxrepair that generates the lowest user
+            // dissatisfaction at the station
+            int actual
+                = getBestRepair(instance, chosenStation, curUsable[chosenStation], curBroken[chosenStation], maxrepair);
+            rSchemeVec[insertIdx].repairingQuantity += actual;
             curUsable[chosenStation] += actual;
             curBroken[chosenStation] -= actual;
             extraTime -= actual * params.repairTime;
@@ -649,98 +739,120 @@ void truckSchemeAmendment(Params &params, std::vector<RSchemeT> &rSchemeVec, std
     std::vector<int> &curBroken, Instance &instance) {
     // total time spent by the truck
     double totalRouteAndTruckTime = params.loadingTime
-                                    * (rSchemeVec[0]->loadingQuantityU + rSchemeVec[0]->loadingQuantityB
-                                        + rSchemeVec[0]->unloadingQuantityU + rSchemeVec[0]->unloadingQuantityB);
-    std::vector<std::tuple<int, int, double>> stationAndPriority;
+                                    * (rSchemeVec[0].loadingQuantityU + rSchemeVec[0].loadingQuantityB
+                                        + rSchemeVec[0].unloadingQuantityU + rSchemeVec[0].unloadingQuantityB);
+    std::vector<std::tuple<int, int, double>> &stationAndPriority = BuildWorkspace::local().truckPriority;
+    stationAndPriority.clear();
     for (int i = 1; i < rSchemeVec.size(); i++) {
-        totalRouteAndTruckTime += instance.dist_mtx[rSchemeVec[i - 1]->station][rSchemeVec[i]->station];
+        totalRouteAndTruckTime += instance.dist_mtx(rSchemeVec[i - 1].station, rSchemeVec[i].station);
         totalRouteAndTruckTime += params.loadingTime
-                                  * (rSchemeVec[i]->loadingQuantityU + rSchemeVec[i]->loadingQuantityB
-                                      + rSchemeVec[i]->unloadingQuantityU + rSchemeVec[i]->unloadingQuantityB);
-        if (rSchemeVec[i]->station != 0
-            && (curUsable[rSchemeVec[i]->station] != instance.networkInfo[rSchemeVec[i]->station].targetUsable
-                || curBroken[rSchemeVec[i]->station] > 0)) {
-            stationAndPriority.emplace_back(rSchemeVec[i]->station, i,
-                getPriority(instance, rSchemeVec[i]->station, curUsable[rSchemeVec[i]->station],
-                    curBroken[rSchemeVec[i]->station]));
+                                  * (rSchemeVec[i].loadingQuantityU + rSchemeVec[i].loadingQuantityB
+                                      + rSchemeVec[i].unloadingQuantityU + rSchemeVec[i].unloadingQuantityB);
+        if (rSchemeVec[i].station != 0
+            && (curUsable[rSchemeVec[i].station] != instance.networkInfo[rSchemeVec[i].station].targetUsable
+                || curBroken[rSchemeVec[i].station] > 0)) {
+            stationAndPriority.emplace_back(rSchemeVec[i].station, i,
+                getPriority(instance, rSchemeVec[i].station, curUsable[rSchemeVec[i].station],
+                    curBroken[rSchemeVec[i].station]));
         }
     }
 
     double extraTime = params.timeBudget - totalRouteAndTruckTime;
-    // std::cout << extraTime << std::endl;
-    while (extraTime >= 2 * params.loadingTime && !stationAndPriority.empty()) {
-        auto [curStation, idx, priority] = stationAndPriority[0];
+    if (extraTime < 2 * params.loadingTime || stationAndPriority.empty()) { return; }
+    BuildWorkspace &workspace = BuildWorkspace::local();
+    // the loads of the truck are kept in the profile during the amendment
+    LoadProfile &loads = workspace.amendmentLoads;
+    loads.assign(params.vehicleCapacity, rSchemeVec);
+    const int schemeSize = static_cast<int>(rSchemeVec.size());
+    // nextDepotOf[i] is the first depot of the scheme from i on, i itself if
+    // there is none
+    std::vector<int> &nextDepotOf = workspace.nextDepot;
+    nextDepotOf.resize(schemeSize);
+    // nextReceiverOf[i] is the first stop from i on that takes usable bikes, a
+    // depot or a station below its target, schemeSize if there is none. Only
+    // the providers lose usable bikes during the amendment and they stay at or
+    // above their target, so the receivers do not change
+    std::vector<int> &nextReceiverOf = workspace.nextReceiver;
+    nextReceiverOf.resize(schemeSize);
+    for (int i = schemeSize - 1, depot = -1, receiver = schemeSize; i >= 0; i--) {
+        int station = rSchemeVec[i].station;
+        if (station == 0) { depot = i; }
+        if (station == 0 || curUsable[station] < instance.networkInfo[station].targetUsable) { receiver = i; }
+        nextDepotOf[i] = depot == -1 ? i : depot;
+        nextReceiverOf[i] = receiver;
+    }
+    for (std::size_t k = 0; k < stationAndPriority.size() && extraTime >= 2 * params.loadingTime; k++) {
+        auto [curStation, idx, priority] = stationAndPriority[k];
         int provider = std::max(curUsable[curStation] - instance.networkInfo[curStation].targetUsable, 0);
         if (provider > 0) {
             // find the next closest depot in the scheme (including the residual
             // capacity at the depot after the original depot operation
             int nextDepot = idx;
-            int minimumResidual = params.vehicleCapacity - rSchemeVec[idx]->truckUQ - rSchemeVec[idx]->truckBQ;
+            int minimumResidual = loads.minResidual(idx, idx + 1);
             // find out the minimum residual capacity of the truck from
             // rSchemeVec[nextDepot] to rSchemeVec[rSchemeVec.size() - 1]
-            for (int i = idx; i < rSchemeVec.size(); i++) {
+            for (int i = idx; i < schemeSize; i++) {
+                // the stops before the next receiver get a load of 0 as long as
+                // the truck has room left on them, they only bound the room
+                if (nextReceiverOf[i] > i) {
+                    int skippedResidual = std::min(minimumResidual, loads.minResidual(i, nextReceiverOf[i]));
+                    if (skippedResidual >= 0) {
+                        minimumResidual = skippedResidual;
+                        i = nextReceiverOf[i];
+                        if (i == schemeSize) { break; }
+                    }
+                }
                 int deviation = std::max(
-                    instance.networkInfo[rSchemeVec[i]->station].targetUsable - curUsable[rSchemeVec[i]->station], 0);
-                if (rSchemeVec[i]->station == 0 || deviation > 0) {
+                    instance.networkInfo[rSchemeVec[i].station].targetUsable - curUsable[rSchemeVec[i].station], 0);
+                if (rSchemeVec[i].station == 0 || deviation > 0) {
                     nextDepot = i;
 
-                    if (rSchemeVec[i]->station == 0) { deviation = 9999; }
+                    if (rSchemeVec[i].station == 0) { deviation = 9999; }
                 }
-                minimumResidual = std::min(
-                    {minimumResidual, params.vehicleCapacity - rSchemeVec[i]->truckUQ - rSchemeVec[i]->truckBQ});
-                int addedLoad = std::min(
-                    {deviation, minimumResidual, curUsable[curStation] - instance.networkInfo[curStation].targetUsable,
-                        TimeHelper::maxLoadQByTime(params, extraTime)});
+                minimumResidual = std::min(minimumResidual, loads.minResidual(i, i + 1));
+                int loadable = std::min(curUsable[curStation] - instance.networkInfo[curStation].targetUsable,
+                    TimeHelper::maxLoadQByTime(params, extraTime));
+                int addedLoad = std::min({deviation, minimumResidual, loadable});
                 minimumResidual -= addedLoad;
-                rSchemeVec[idx]->loadingQuantityU += addedLoad;
-                curUsable[curStation] -= addedLoad;
-                rSchemeVec[nextDepot]->unloadingQuantityU += addedLoad;
-                for (int i = idx; i < nextDepot; i++) { rSchemeVec[i]->truckUQ += addedLoad; }
-                provider -= addedLoad;
-                extraTime -= 2 * addedLoad * params.loadingTime;
+                if (addedLoad != 0) {
+                    rSchemeVec[idx].loadingQuantityU += addedLoad;
+                    curUsable[curStation] -= addedLoad;
+                    rSchemeVec[nextDepot].unloadingQuantityU += addedLoad;
+                    loads.addUsable(idx, nextDepot, addedLoad);
+                    provider -= addedLoad;
+                    extraTime -= 2 * addedLoad * params.loadingTime;
+                } else if ((loadable == 0 || minimumResidual == 0) && loads.minResidual(i + 1, schemeSize) >= 0) {
+                    // nothing is left to load, no time or no room: the next
+                    // stops would all get a load of 0
+                    break;
+                }
             }
         }
 
         if (extraTime >= 2 * params.loadingTime && curBroken[curStation] > 0) {
-            // find the next closest depot in the scheme (including the residual
-            // capacity at the depot after the original depot operation
-            int nextDepot = idx;
-            for (int i = idx; i < rSchemeVec.size(); i++) {
-                if (rSchemeVec[i]->station == 0) {
-                    nextDepot = i;
-                    break;
-                }
-            }
-            int minimumResidual = params.vehicleCapacity - rSchemeVec[idx]->truckUQ - rSchemeVec[idx]->truckBQ;
-            // find out the minimum residual capacity of the truck from
-            // rSchemeVec[nextDepot] to rSchemeVec[rSchemeVec.size() - 1]
-            for (int i = idx; i < nextDepot; i++) {
-                minimumResidual = std::min(
-                    {minimumResidual, params.vehicleCapacity - rSchemeVec[i]->truckUQ - rSchemeVec[i]->truckBQ});
-            }
+            // the broken bikes are unloaded at the next closest depot, the truck
+            // needs room for them from the station to the depot
+            int nextDepot = nextDepotOf[idx];
+            int minimumResidual = std::min(loads.minResidual(idx, idx + 1), loads.minResidual(idx, nextDepot));
             int addedLoad
                 = std::min({minimumResidual, curBroken[curStation], TimeHelper::maxLoadQByTime(params, extraTime)});
-            rSchemeVec[idx]->loadingQuantityB += addedLoad;
+            rSchemeVec[idx].loadingQuantityB += addedLoad;
             curBroken[curStation] -= addedLoad;
-            rSchemeVec[nextDepot]->unloadingQuantityB += addedLoad;
-            for (int i = idx; i < nextDepot; i++) { rSchemeVec[i]->truckBQ += addedLoad; }
+            rSchemeVec[nextDepot].unloadingQuantityB += addedLoad;
+            loads.addBroken(idx, nextDepot, addedLoad);
             extraTime -= 2 * addedLoad * params.loadingTime;
         }
-        stationAndPriority.erase(stationAndPriority.begin());
     }
+    loads.writeTo(rSchemeVec);
 }
 
-void unSatUpdateOverwrite(
-    UnsatList &unSatStation, const int &curStation, const int &idx, const int &surplus, const double &priority) {
+// the priority of the station is only looked up when there is a surplus to
+// record
+void unSatUpdateOverwrite(UnsatList &unSatStation, const int &curStation, const int &idx, const int &surplus,
+    const std::vector<int> &curUsable, const std::vector<int> &curBroken, Instance &instance) {
     if (surplus == 0) { return; }
-    auto it = std::find_if(unSatStation.begin(), unSatStation.end(),
-        [curStation](const auto &station) { return std::get<0>(station) == curStation; });
-    if (it != unSatStation.end()) {
-        std::get<2>(*it) = surplus;
-        std::get<3>(*it) = priority;
-    } else {
-        unSatStation.emplace_back(curStation, idx, surplus, priority);
-    }
+    unSatStation.overwrite(
+        curStation, idx, surplus, getPriority(instance, curStation, curUsable[curStation], curBroken[curStation]));
 }
 
 void extraUpdate(std::vector<std::pair<int, double>> &uldExtraTime, const int &curStation, const double &extraTime) {
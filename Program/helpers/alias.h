@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include <vector>
+#include "UnsatTracker.h"
 
-// setting the alias for UnsatList as UnsatList
-using UnsatList = std::vector<std::tuple<int, int, int, double>>;
+// setting the alias for UnsatList as UnsatTracker
+using UnsatList = UnsatTracker;
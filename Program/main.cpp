@@ -3,23 +3,79 @@
 #include "Instance.h"
 #include "Params.h"
 #include "helpers/Args.h"
+#include "helpers/BinaryHelper.h"
 #include "helpers/FileHelper.h"
+#include "helpers/ShmHelper.h"
 #include "helpers/cmdparser.hpp"
+#include <fstream>
+#include <iostream>
 #include <string>
 
+// Loads the instance from its folder, or from the packed stream given by -in
+Instance loadInstance() {
+  const std::string instNo = std::to_string(Args::nbInst);
+  if (Args::instanceStream.empty()) {
+    return Instance(Args::nbStns, instNo, Args::brokenProp, Args::isProportion,
+                    !Args::textInstance, Args::loadThreads,
+                    Args::sharedInstance);
+  }
+  if (Args::instanceStream == "-") {
+    return Instance(std::cin, "stdin", Args::brokenProp, Args::isProportion);
+  }
+  std::ifstream stream(Args::instanceStream, std::ios::binary);
+  if (!stream) {
+    throw std::runtime_error("Could not open file: " + Args::instanceStream);
+  }
+  return Instance(stream, Args::instanceStream, Args::brokenProp,
+                  Args::isProportion);
+}
+
 int main(int argc, char *argv[]) {
   cli::Parser parser(argc, argv);
   Args::parseArgs(argc, argv);
-  Instance instance(Args::nbStns, std::to_string(Args::nbInst),
-                    Args::brokenProp, Args::isProportion);
+  if (Args::compileBinary) {
+    std::string imagePath = BinaryHelper::compileInstance(
+        Args::nbStns, std::to_string(Args::nbInst), Args::loadThreads);
+    if (imagePath.empty()) {
+      std::cerr << "Failed to compile the instance" << std::endl;
+      return 1;
+    }
+    std::cout << "Compiled instance written to " << imagePath << std::endl;
+    return 0;
+  }
+  if (Args::unlinkShared) {
+    std::string name = ShmHelper::segmentName(Args::nbStns, std::to_string(Args::nbInst));
+    bool removed = ShmHelper::unlinkShared(Args::nbStns, std::to_string(Args::nbInst));
+    std::cout << (removed ? "Removed shared instance " : "No shared instance ") << name << std::endl;
+    return 0;
+  }
+  Instance instance = loadInstance();
+  if (instance.nbClients != Args::nbStns) {
+    std::cerr << "The instance stream holds " << instance.nbClients
+              << " stations, run with -ns " << instance.nbClients << std::endl;
+    return 1;
+  }
+  instance.computeNeighbors(Args::neighbors);
   // Initialize the parameters
   Params params = Params(
       Args::nbStns, Args::nbTrk, Args::nbRpm, Args::vehicleCapacity,
       Args::repairTime, Args::loadingTime, Args::mu, Args::lambda,
       Args::nbIterPenaltyManagement, Args::targetFeasible, Args::nbIterNoImp,
       Args::timeBudget, Args::penaltyCapacity, Args::timeLimit, Args::itEDU);
+  params.repairmanCache.setCapacity(Args::repairmanCache);
+  params.ap.fleetScopedMoves = Args::fleetMoves;
+  params.evaluationCache.setCapacity(Args::evaluationCache);
+  params.ap.leanIndividuals = Args::leanIndividuals;
+  params.ap.singlePassAssignment = Args::singlePass;
+  params.ap.optimalRepairTime = Args::repairKnapsack;
   Genetic genetic(params, instance);
   Individual bestSol = genetic.run();
+  std::cout << "Repairman cache: " << params.repairmanCache.hits() << " hits, "
+            << params.repairmanCache.misses() << " misses" << std::endl;
+  std::cout << "Evaluation cache: " << params.evaluationCache.hits()
+            << " evaluations avoided, " << params.evaluationCache.misses()
+            << " individuals built" << std::endl;
+  genetic.localSearch.printMoveStats(std::cout);
   FileHelper::saveResult(bestSol, params, Args::nbStns, Args::nbInst,
                          Args::brokenProp, genetic);
   // std::vector<std::vector<int>> trkRoute = {{0, 1, 2, 13, 6, 0}};
@@ -34,4 +90,4 @@ int main(int argc, char *argv[]) {
 
   //   bestSol.displayAnIndividual();
   return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
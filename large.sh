@@ -36,7 +36,7 @@ for n_station in "${!station_instances[@]}"; do
 
           # Start a new screen session and run the command
           screen -dmS "$session_name" bash -c "
-                        ./main -ns '$n_station' -i '$inst' -edu 20 -ntrk '$ntrk' -nrpm '$nrpm' -noimp 5000 -tb '$tb';
+                        ./main -ns '$n_station' -i '$inst' -shm -edu 20 -ntrk '$ntrk' -nrpm '$nrpm' -noimp 5000 -tb '$tb';
                         exit
                     "
 
@@ -52,3 +52,14 @@ done
 
 # Final wait to ensure all sessions complete before the script exits
 wait
+
+# Remove the shared instances once the last runs are done
+while screen -ls | grep -q 'ns_'; do
+  sleep 10
+done
+for n_station in "${!station_instances[@]}"; do
+  IFS=' ' read -r -a inst_list <<<"${station_instances[$n_station]}"
+  for inst in "${inst_list[@]}"; do
+    ./main -ns "$n_station" -i "$inst" -shmrm
+  done
+done
@@ -0,0 +1,27 @@
+#!/bin/bash
+# Packs the text files of Instances/<nbStations>_<instNo> into one instance stream written to stdout, to be read
+# with `./main -ns <nbStations> -in -` (or `-in <file>`) without staging the files on disk:
+#   ./pack_instance.sh 60 1 | (cd build && ./main -ns 60 -in -)
+ns=$1
+inst=${2:-1}
+dir="$(dirname "$0")/Instances/${ns}_${inst}"
+if [ -z "$ns" ] || [ ! -d "$dir" ]; then
+  echo "usage: $0 <nbStations> [instNo]" >&2
+  exit 1
+fi
+
+# section header "<name> [station] <length in bytes>", then the file itself
+section() {
+  echo "$1 $(wc -c <"$2")"
+  cat "$2"
+}
+
+echo "BRPWR-STREAM 1 $ns"
+section station_info "$dir/station_info_$ns.txt"
+section time_matrix "$dir/time_matrix_$ns.txt"
+for ((s = 1; s <= ns; s++)); do
+  section "dissat_table $s" "$dir/dissat_table_$s.txt"
+  section "BCRF $s" "$dir/BCRF_$s.txt"
+  section "BCRFR $s" "$dir/BCRFR_$s.txt"
+done
+echo end